@@ -0,0 +1,618 @@
+//
+// Batch.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Batched evaluation of the cross sections of TCrossSection over arrays
+// of events, for callers that hold their kinematics in flat arrays of
+// doubles, such as the NumPy interface in python_bindings.cxx.
+//
+// Each external leg of a process is described by a Batch_leg_t, which
+// points to the four-momenta (E,px,py,pz) of the leg in all events, and
+// optionally to its polarization vectors, in the encoding of
+// TPhoton::SetPol and TLepton::SetPol.  The arrays are read through row
+// and column strides counted in doubles, so that they can be views into
+// larger arrays, and a row stride of zero repeats the same momentum or
+// polarization for every event, as for a fixed beam.  A leg without
+// polarizations is unpolarized if it is in the initial state, and
+// summed over final spins if it is in the final state, the same as for
+// SetPol(0) and AllPol.  The legs are given in the order of the
+// arguments of the corresponding method of TCrossSection, listed for
+// each process in Batch_processes.
+//
+// The events are split into nthreads contiguous ranges, which are
+// evaluated in parallel on the worker pool of Pool.h and the calling
+// thread, each range with its own TPhoton and TLepton objects, so the
+// results do not depend on the number of threads.  Each event is still
+// computed by one call to the scalar TCrossSection method: the batch
+// runs the scalar kernels in parallel over the events, it does not use
+// SIMD kernels that evaluate several events at once.
+//
+// The momenta and polarizations can be kept in Batch_vectors_t, which
+// owns them by component or wraps an external array, and whose data
+// and strides can be given to the legs directly.  The arrays owned by
+// Batch_vectors_t are given back to a free list when it is destroyed,
+// and reused by the next one of the same size, so that a generator that
+// makes a new set of vectors for each block of events, like the one in
+// ComptonSource.C, only calls malloc for its first blocks.
+//
+// Batch_lorentz applies the kinematic operations of TFourVectorReal,
+// boosts, rotations, invariant masses, scalar products and polar
+// decompositions, to arrays of four-vectors in the same way.  The boosts
+// and rotations go through one TFourVectorReal per event, so that the
+// results are the same as those of the methods called on each vector in
+// turn, while the invariant masses, scalar products and polar angles are
+// computed in double precision by direct loops over the arrays.
+
+#ifndef DIRACXX_BATCH
+#define DIRACXX_BATCH
+
+#include <thread>
+#include <mutex>
+#include <math.h>
+
+#include "Double.h"
+#include "Pool.h"
+#include "TPhoton.h"
+#include "TLepton.h"
+#include "TCrossSection.h"
+#include "TAmplitudeTensor.h"
+#include "TFourVectorReal.h"
+#include "TLorentzBoost.h"
+#include "TThreeRotation.h"
+
+enum EBatch_process {
+   kBatchCompton = 0,
+   kBatchBremsstrahlung = 1,
+   kBatchPairProduction = 2,
+   kBatchTripletProduction = 3,
+   kBatchBetheHeitlerNucleon = 4,
+   kBatchEEBremsstrahlung = 5,
+   kBatchEPairProduction = 6,
+   kBatchETripletProduction = 7,
+   kBatchProcesses = 8
+};
+
+const Int_t Batch_max_legs = 6;
+
+struct Batch_process_t {
+   const char *name;          // name of the TCrossSection method
+   Int_t nlegs;               // number of external legs
+   UInt_t photons;            // bit mask of the legs that are photons
+   UInt_t initial;            // bit mask of the initial-state legs
+   Int_t nparams;             // number of parameters per event
+   LDouble_t mass[Batch_max_legs];  // default lepton masses
+};
+
+const Batch_process_t Batch_processes[kBatchProcesses] = {
+   {"Compton", 4, (1 << 0) + (1 << 2), (1 << 0) + (1 << 1), 0,
+    {0, mElectron, 0, mElectron}},
+   {"Bremsstrahlung", 3, (1 << 2), (1 << 0), 0,
+    {mElectron, mElectron, 0}},
+   {"PairProduction", 3, (1 << 0), (1 << 0), 0,
+    {0, mElectron, mElectron}},
+   {"TripletProduction", 5, (1 << 0), (1 << 0) + (1 << 1), 0,
+    {0, mElectron, mElectron, mElectron, mElectron}},
+   {"BetheHeitlerNucleon", 5, (1 << 0), (1 << 0) + (1 << 1), 4,
+    {0, mProton, mElectron, mElectron, mProton}},
+   {"eeBremsstrahlung", 5, (1 << 4), (1 << 0) + (1 << 1), 0,
+    {mElectron, mElectron, mElectron, mElectron, 0}},
+   {"ePairProduction", 4, 0, (1 << 0), 0,
+    {mElectron, mElectron, mElectron, mElectron}},
+   {"eTripletProduction", 6, 0, (1 << 0) + (1 << 4), 0,
+    {mElectron, mElectron, mElectron, mElectron, mElectron, mElectron}}
+};
+
+struct Batch_leg_t {
+   const Double_t *mom;       // four-momenta of the leg
+   Long64_t momRow;           // stride between events, 0 to repeat
+   Long64_t momCol;           // stride between components
+   const Double_t *pol;       // polarization vectors, or 0
+   Long64_t polRow;
+   Long64_t polCol;
+   LDouble_t mass;            // mass of a lepton leg
+
+   Batch_leg_t() : mom(0), momRow(4), momCol(1), pol(0), polRow(3),
+                   polCol(1), mass(0) { }
+};
+
+const Int_t Batch_free_max = 64;
+
+class Batch_free_t {
+
+   // The arrays given back by Batch_vectors_t, up to Batch_free_max of
+   // them, with their sizes in doubles.  Those given back when the list
+   // is full are freed.
+
+public:
+   Batch_free_t() : fCount(0) { }
+
+   ~Batch_free_t()
+   {
+      for (Int_t i=0; i < fCount; i++)
+         delete [] fData[i];
+   }
+
+   Double_t *Take(Long64_t size)
+   {
+      // Returns a zeroed array of size doubles, from the list if there is
+      // one of that size in it, else from new.
+
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         for (Int_t i=fCount - 1; i >= 0; i--) {
+            if (fSize[i] == size) {
+               Double_t *data = fData[i];
+               --fCount;
+               fData[i] = fData[fCount];
+               fSize[i] = fSize[fCount];
+               for (Long64_t j=0; j < size; j++)
+                  data[j] = 0;
+               return data;
+            }
+         }
+      }
+      return new Double_t[size]();
+   }
+
+   void Give(Double_t *data, Long64_t size)
+   {
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         if (fCount < Batch_free_max) {
+            fData[fCount] = data;
+            fSize[fCount] = size;
+            ++fCount;
+            return;
+         }
+      }
+      delete [] data;
+   }
+
+private:
+   Int_t fCount;
+   Double_t *fData[Batch_free_max];
+   Long64_t fSize[Batch_free_max];
+   std::mutex fLock;
+};
+
+inline Batch_free_t &Batch_free()
+{
+   static Batch_free_t list;
+   return list;
+}
+
+class Batch_vectors_t {
+
+   // A batch of n real vectors of ncomp components each, such as the
+   // momenta or polarizations of one leg, stored either in an array
+   // owned by the batch, by component (structure of arrays), so that
+   // each component is contiguous over the events, or in an external
+   // array with arbitrary strides, such as a NumPy array, without
+   // copying.  Element (i,c) is at Data()[i*RowStride() + c*ColStride()].
+
+public:
+   Batch_vectors_t(Long64_t n, Int_t ncomp=4)
+    : fSize(n), fComponents(ncomp), fRowStride(1), fColStride(n),
+      fOwner(true)
+   {
+      fData = Batch_free().Take(n * ncomp);
+   }
+
+   Batch_vectors_t(Double_t *data, Long64_t n, Int_t ncomp,
+                   Long64_t rowStride, Long64_t colStride)
+    : fData(data), fSize(n), fComponents(ncomp), fRowStride(rowStride),
+      fColStride(colStride), fOwner(false)
+   { }
+
+   ~Batch_vectors_t()
+   {
+      if (fOwner)
+         Batch_free().Give(fData, fSize * fComponents);
+   }
+
+   Double_t *Data() const { return fData; }
+   Long64_t Size() const { return fSize; }
+   Int_t Components() const { return fComponents; }
+   Long64_t RowStride() const { return fRowStride; }
+   Long64_t ColStride() const { return fColStride; }
+   Bool_t IsView() const { return !fOwner; }
+
+   Double_t &operator()(Long64_t i, Int_t c) const
+   {
+      return fData[i * fRowStride + c * fColStride];
+   }
+
+private:
+   Batch_vectors_t(const Batch_vectors_t &src);
+   Batch_vectors_t &operator=(const Batch_vectors_t &src);
+
+   Double_t *fData;
+   Long64_t fSize;
+   Int_t fComponents;
+   Long64_t fRowStride;       // strides in doubles
+   Long64_t fColStride;
+   Bool_t fOwner;             // fData is given back with the batch
+};
+
+struct Batch_params_t {
+   const Double_t *par;       // parameters of each event, or 0
+   Long64_t parRow;           // see Batch_processes for their meaning
+   Long64_t parCol;
+
+   Batch_params_t() : par(0), parRow(0), parCol(1) { }
+};
+
+inline LDouble_t Batch_evaluate(Int_t process, TPhoton *g, TLepton *l,
+                                const LDouble_t *par)
+{
+   // Returns the cross section for one event, with the photon legs in
+   // g and the lepton legs in l, both indexed by leg number.
+
+   switch (process) {
+   case kBatchCompton:
+      return TCrossSection::Compton(g[0], l[1], g[2], l[3]);
+   case kBatchBremsstrahlung:
+      return TCrossSection::Bremsstrahlung(l[0], l[1], g[2]);
+   case kBatchPairProduction:
+      return TCrossSection::PairProduction(g[0], l[1], l[2]);
+   case kBatchTripletProduction:
+      return TCrossSection::TripletProduction(g[0], l[1], l[2], l[3], l[4]);
+   case kBatchBetheHeitlerNucleon:
+      return TCrossSection::BetheHeitlerNucleon(g[0], l[1], l[2], l[3], l[4],
+                                                par[0], par[1], par[2],
+                                                par[3]);
+   case kBatchEEBremsstrahlung:
+      return TCrossSection::eeBremsstrahlung(l[0], l[1], l[2], l[3], g[4]);
+   case kBatchEPairProduction:
+      return TCrossSection::ePairProduction(l[0], l[1], l[2], l[3]);
+   case kBatchETripletProduction:
+      return TCrossSection::eTripletProduction(l[0], l[1], l[2], l[3],
+                                               l[4], l[5]);
+   }
+   return 0;
+}
+
+inline Bool_t Batch_amplitude(Int_t process, TPhoton *g, TLepton *l,
+                              const LDouble_t *par, TAmplitudeTensor &amp)
+{
+   // Fills amp with the helicity amplitudes for one event, as for
+   // Batch_evaluate, and returns false for the processes that do not
+   // have an amplitude method in TCrossSection.
+
+   switch (process) {
+   case kBatchCompton:
+      TCrossSection::ComptonAmplitude(g[0], l[1], g[2], l[3], amp);
+      return true;
+   case kBatchBremsstrahlung:
+      TCrossSection::BremsstrahlungAmplitude(l[0], l[1], g[2], amp);
+      return true;
+   case kBatchPairProduction:
+      TCrossSection::PairProductionAmplitude(g[0], l[1], l[2], amp);
+      return true;
+   case kBatchTripletProduction:
+      TCrossSection::TripletProductionAmplitude(g[0], l[1], l[2], l[3], l[4],
+                                                amp);
+      return true;
+   case kBatchBetheHeitlerNucleon:
+      TCrossSection::BetheHeitlerNucleonAmplitude(g[0], l[1], l[2], l[3], l[4],
+                                                  par[0], par[1], par[2],
+                                                  par[3], amp);
+      return true;
+   case kBatchEPairProduction:
+      TCrossSection::ePairProductionAmplitude(l[0], l[1], l[2], l[3], amp);
+      return true;
+   case kBatchETripletProduction:
+      TCrossSection::eTripletProductionAmplitude(l[0], l[1], l[2], l[3],
+                                                 l[4], l[5], amp);
+      return true;
+   }
+   return false;
+}
+
+inline Bool_t Batch_has_amplitude(Int_t process)
+{
+   return (process >= 0 && process < kBatchProcesses &&
+           process != kBatchEEBremsstrahlung);
+}
+
+inline void Batch_setup(Int_t process, const Batch_leg_t *legs,
+                        TPhoton *g, TLepton *l)
+{
+   // Sets the masses of the leptons, and the polarization states of the
+   // legs that are not given polarizations.
+
+   const Batch_process_t &proc = Batch_processes[process];
+   for (Int_t leg=0; leg < proc.nlegs; leg++) {
+      l[leg].SetMass(legs[leg].mass);
+      Bool_t initial = (proc.initial & (1 << leg)) != 0;
+      if (legs[leg].pol != 0) {
+         continue;
+      }
+      else if (proc.photons & (1 << leg)) {
+         if (initial)
+            g[leg].SetPol(TThreeVectorReal(0,0,0));
+         else
+            g[leg].AllPol();
+      }
+      else {
+         if (initial)
+            l[leg].SetPol(TThreeVectorReal(0,0,0));
+         else
+            l[leg].AllPol();
+      }
+   }
+}
+
+inline void Batch_load(Int_t process, Long64_t n, const Batch_leg_t *legs,
+                       TPhoton *g, TLepton *l)
+{
+   // Sets the momenta and the given polarizations of event n.
+
+   const Batch_process_t &proc = Batch_processes[process];
+   for (Int_t leg=0; leg < proc.nlegs; leg++) {
+      const Batch_leg_t &b = legs[leg];
+      const Double_t *p = b.mom + n * b.momRow;
+      TFourVectorReal mom(p[0], p[b.momCol], p[2*b.momCol], p[3*b.momCol]);
+      Bool_t photon = (proc.photons & (1 << leg)) != 0;
+      if (photon)
+         g[leg].SetMom(mom);
+      else
+         l[leg].SetMom(mom);
+      if (b.pol != 0) {
+         const Double_t *s = b.pol + n * b.polRow;
+         TThreeVectorReal pol(s[0], s[b.polCol], s[2*b.polCol]);
+         if (photon)
+            g[leg].SetPol(pol);
+         else
+            l[leg].SetPol(pol);
+      }
+   }
+}
+
+inline void Batch_range(Int_t process, Long64_t first, Long64_t last,
+                        const Batch_leg_t *legs, Batch_params_t params,
+                        Double_t *result)
+{
+   // Evaluates the cross sections of events first..last-1.
+
+   const Batch_process_t &proc = Batch_processes[process];
+   TPhoton g[Batch_max_legs];
+   TLepton l[Batch_max_legs];
+   Batch_setup(process, legs, g, l);
+   LDouble_t par[4] = {0, 0, 0, 0};
+   for (Long64_t n=first; n < last; n++) {
+      Batch_load(process, n, legs, g, l);
+      for (Int_t i=0; i < proc.nparams; i++)
+         par[i] = params.par[n * params.parRow + i * params.parCol];
+      result[n] = Batch_evaluate(process, g, l, par);
+   }
+}
+
+inline void Batch_amplitude_range(Int_t process, Long64_t first,
+                                  Long64_t last, const Batch_leg_t *legs,
+                                  Batch_params_t params, Double_t *amps,
+                                  Double_t *kin)
+{
+   // Evaluates the amplitudes of events first..last-1, see
+   // Batch_amplitudes.
+
+   const Batch_process_t &proc = Batch_processes[process];
+   TPhoton g[Batch_max_legs];
+   TLepton l[Batch_max_legs];
+   TAmplitudeTensor amp;
+   Batch_setup(process, legs, g, l);
+   Int_t size = 1 << proc.nlegs;
+   LDouble_t par[4] = {0, 0, 0, 0};
+   for (Long64_t n=first; n < last; n++) {
+      Batch_load(process, n, legs, g, l);
+      for (Int_t i=0; i < proc.nparams; i++)
+         par[i] = params.par[n * params.parRow + i * params.parCol];
+      Batch_amplitude(process, g, l, par, amp);
+      Double_t *out = amps + 2 * size * n;
+      for (Int_t i=0; i < size; i++) {
+         out[2*i] = amp[i].real();
+         out[2*i + 1] = amp[i].imag();
+      }
+      kin[n] = amp.KinFactor();
+   }
+}
+
+inline Int_t Batch_threads(Int_t nthreads, Long64_t nevents)
+{
+   if (nthreads <= 0)
+      nthreads = std::thread::hardware_concurrency();
+   if (nthreads > nevents)
+      nthreads = (nevents > 0)? nevents : 1;
+   return (nthreads > 0)? nthreads : 1;
+}
+
+inline void Batch_cross_sections(Int_t process, Long64_t nevents,
+                                 const Batch_leg_t *legs,
+                                 Batch_params_t params, Double_t *result,
+                                 Int_t nthreads=1)
+{
+   // Fills result[0..nevents-1] with the cross sections of process for
+   // the kinematics in legs, in the units of the TCrossSection method,
+   // in nthreads parallel ranges, or one per core if nthreads is zero.  The
+   // processes that take parameters, at present only the nucleon form
+   // factors F1,F2 spacelike and F1,F2 timelike of BetheHeitlerNucleon,
+   // read them from params.
+
+   nthreads = Batch_threads(nthreads, nevents);
+   Pool_run(nthreads, [&](Long64_t i) {
+      Batch_range(process, nevents * i / nthreads,
+                  nevents * (i + 1) / nthreads, legs, params, result);
+   });
+}
+
+inline void Batch_amplitudes(Int_t process, Long64_t nevents,
+                             const Batch_leg_t *legs, Batch_params_t params,
+                             Double_t *amps, Double_t *kin, Int_t nthreads=1)
+{
+   // Fills amps with the helicity amplitudes of each event, as 2^nlegs
+   // complex numbers (real, imaginary) in the order of TAmplitudeTensor,
+   // and kin with the kinematical factors that convert |M|^2 into the
+   // cross section, for the processes with Batch_has_amplitude.  The
+   // polarizations of the legs are not used, the parameters are read
+   // from params as for Batch_cross_sections.
+
+   if (!Batch_has_amplitude(process))
+      return;
+   nthreads = Batch_threads(nthreads, nevents);
+   Pool_run(nthreads, [&](Long64_t i) {
+      Batch_amplitude_range(process, nevents * i / nthreads,
+                            nevents * (i + 1) / nthreads, legs, params,
+                            amps, kin);
+   });
+}
+
+
+enum EBatch_lorentz {
+   kBatchBoost = 0,
+   kBatchBoostToRest = 1,
+   kBatchRotate = 2,
+   kBatchRotateEuler = 3,
+   kBatchInvariant = 4,
+   kBatchScalarProd = 5,
+   kBatchPolar = 6,
+   kBatchLorentzOps = 7
+};
+
+struct Batch_lorentz_t {
+   const char *name;          // name of the TFourVectorReal method
+   Int_t nargs;               // components of the argument of each event
+   Int_t nout;                // components of the result of each event
+};
+
+// The argument of each operation, read through a Batch_array_t, is the
+// velocity beta of the boost (Boost), the four-momentum of the frame
+// (BoostToRest), the rotation axis scaled by the angle
+// of rotation in radians (Rotate, as for TThreeRotation(axis)), the
+// Euler angles phi,theta,psi (RotateEuler), or the other four-vector
+// (ScalarProd).  The result is the transformed four-vector, the
+// invariant mass, the scalar product, or (r,theta,phi) of the momentum.
+
+const Batch_lorentz_t Batch_lorentz_ops[kBatchLorentzOps] = {
+   {"Boost", 3, 4},
+   {"BoostToRest", 4, 4},
+   {"Rotate", 3, 4},
+   {"RotateEuler", 3, 4},
+   {"Invariant", 0, 1},
+   {"ScalarProd", 4, 1},
+   {"GetPolar", 0, 3}
+};
+
+struct Batch_array_t {
+   const Double_t *data;      // element (i,c) at data[i*row + c*col]
+   Long64_t row;              // stride between events, 0 to repeat
+   Long64_t col;              // stride between components
+
+   Batch_array_t() : data(0), row(0), col(1) { }
+   Batch_array_t(const Double_t *d, Long64_t r, Long64_t c)
+    : data(d), row(r), col(c) { }
+};
+
+inline TLorentzTransform Batch_lorentz_transform(Int_t op, const Double_t *a,
+                                                 Long64_t col)
+{
+   // Returns the transform applied by op with the argument a of one event.
+
+   switch (op) {
+   case kBatchBoost:
+      return TLorentzBoost(a[0], a[col], a[2*col]);
+   case kBatchBoostToRest: {
+      TFourVectorReal p(a[0], a[col], a[2*col], a[3*col]);
+      return TLorentzBoost(p/p[0]);
+   }
+   case kBatchRotate:
+      return TThreeRotation(TThreeVectorReal(a[0], a[col], a[2*col]));
+   case kBatchRotateEuler:
+      return TThreeRotation(a[0], a[col], a[2*col]);
+   }
+   return TLorentzTransform();
+}
+
+inline void Batch_lorentz_range(Int_t op, Long64_t first, Long64_t last,
+                                Batch_array_t vec, Batch_array_t arg,
+                                Double_t *result)
+{
+   // Applies op to events first..last-1, see Batch_lorentz.  A transform
+   // with the same argument for every event is only set up once.  The
+   // scalar operations are computed directly from the arrays, in double
+   // precision, with no TFourVectorReal in between.
+
+   const Int_t nout = Batch_lorentz_ops[op].nout;
+   const Double_t *v = vec.data;
+   const Double_t *a = arg.data;
+   const Long64_t vc = vec.col;
+   const Long64_t ac = arg.col;
+   if (op == kBatchInvariant) {
+      // as TFourVectorReal::Invariant, without its error message
+      const Double_t res = (Double_t)TThreeVectorReal(0, 0, 0).Resolution();
+      for (Long64_t n=first; n < last; n++) {
+         const Double_t *p = v + n * vec.row;
+         Double_t p2 = p[vc]*p[vc] + p[2*vc]*p[2*vc] + p[3*vc]*p[3*vc];
+         Double_t m2 = p[0]*p[0] - p2;
+         Double_t scale = sqrt(p[0]*p[0] + p2);
+         Double_t tol = (scale > 0)? res * scale : res;
+         result[n] = (m2 > 0)? sqrt(m2) : (m2 > -tol)? 0 : -1;
+      }
+      return;
+   }
+   else if (op == kBatchScalarProd) {
+      for (Long64_t n=first; n < last; n++) {
+         const Double_t *p = v + n * vec.row;
+         const Double_t *q = a + n * arg.row;
+         result[n] = p[0]*q[0] - p[vc]*q[ac] - p[2*vc]*q[2*ac]
+                                             - p[3*vc]*q[3*ac];
+      }
+      return;
+   }
+   else if (op == kBatchPolar) {
+      for (Long64_t n=first; n < last; n++) {
+         const Double_t *p = v + n * vec.row;
+         Double_t rho2 = p[vc]*p[vc] + p[2*vc]*p[2*vc];
+         Double_t *out = result + n * nout;
+         out[0] = sqrt(rho2 + p[3*vc]*p[3*vc]);
+         out[1] = atan2(sqrt(rho2), p[3*vc]);
+         out[2] = atan2(p[2*vc], p[vc]);
+      }
+      return;
+   }
+
+   TLorentzTransform fixed;
+   if (arg.row == 0)
+      fixed = Batch_lorentz_transform(op, a, ac);
+   for (Long64_t n=first; n < last; n++) {
+      const Double_t *p = v + n * vec.row;
+      TFourVectorReal pt(p[0], p[vc], p[2*vc], p[3*vc]);
+      if (arg.row == 0)
+         pt.Transform(fixed);
+      else
+         pt.Transform(Batch_lorentz_transform(op, a + n * arg.row, ac));
+      Double_t *out = result + n * nout;
+      for (Int_t mu=0; mu < 4; mu++)
+         out[mu] = (Double_t)pt[mu];
+   }
+}
+
+inline void Batch_lorentz(Int_t op, Long64_t nevents, Batch_array_t vec,
+                          Batch_array_t arg, Double_t *result,
+                          Int_t nthreads=1)
+{
+   // Fills result, nout values per event, with op applied to the
+   // four-vectors vec with the arguments arg of each event, in nthreads
+   // parallel ranges on the worker pool, or one per core if nthreads is
+   // zero.
+
+   nthreads = Batch_threads(nthreads, nevents);
+   Pool_run(nthreads, [&](Long64_t i) {
+      Batch_lorentz_range(op, nevents * i / nthreads,
+                          nevents * (i + 1) / nthreads, vec, arg, result);
+   });
+}
+
+#endif
@@ -0,0 +1,441 @@
+//
+// DDouble.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Defines the double-double scalar type DDouble_t, which represents a
+// real number as the unevaluated sum hi + lo of two doubles, with
+// |lo| <= ulp(hi)/2, for a total of 106 bits of mantissa.  All of the
+// arithmetic is done in ordinary double precision registers, so unlike
+// the x87 long double it can be kept in SSE/AVX registers and is open
+// to vectorization by the compiler.  Even so, the package runs at only
+// about 0.3 times the speed of the long double build with it, as
+// measured by precision.cxx, so it is a choice for its 106 bits of
+// precision and not for speed.  The algorithms are those of the
+// QD library of Hida, Li and Bailey.  The type can be substituted for
+// LDouble_t throughout the package by building with the preprocessor
+// symbol DIRACXX_DOUBLE_DOUBLE defined, see Double.h.
+//
+// The error-free transformations below depend on strict IEEE rounding
+// of each double operation, so this code must not be compiled with
+// -ffast-math, nor on the x87 unit in extended precision.
+
+#ifndef DIRACXX_DDOUBLE
+#define DIRACXX_DDOUBLE
+
+#include <cmath>
+#include <iostream>
+
+class DDouble_t {
+
+public:
+   DDouble_t() : hi(0), lo(0) { }
+   DDouble_t(const double x) : hi(x), lo(0) { }
+   DDouble_t(const float x) : hi(x), lo(0) { }
+   DDouble_t(const int x) : hi(x), lo(0) { }
+   DDouble_t(const unsigned int x) : hi(x), lo(0) { }
+   DDouble_t(const long double x) : hi(x), lo(x - (long double)hi) { }
+   DDouble_t(const long x) : DDouble_t((long double)x) { }
+   DDouble_t(const unsigned long x) : DDouble_t((long double)x) { }
+   DDouble_t(const long long x) : DDouble_t((long double)x) { }
+   DDouble_t(const unsigned long long x) : DDouble_t((long double)x) { }
+   DDouble_t(const double h, const double l) : hi(h), lo(l) { }
+
+   // The conversions to the built-in types are explicit, so that a
+   // silent loss of precision cannot creep into the package code.
+   explicit operator double() const { return hi; }
+   explicit operator float() const { return (float)hi; }
+   explicit operator long double() const { return (long double)hi + lo; }
+
+   DDouble_t operator-() const { return DDouble_t(-hi, -lo); }
+   DDouble_t &operator+=(const DDouble_t &b);
+   DDouble_t &operator-=(const DDouble_t &b);
+   DDouble_t &operator*=(const DDouble_t &b);
+   DDouble_t &operator/=(const DDouble_t &b);
+
+   static DDouble_t TwoSum(const double a, const double b);
+   static DDouble_t QuickTwoSum(const double a, const double b);
+   static DDouble_t TwoProd(const double a, const double b);
+
+   double hi;
+   double lo;
+};
+
+//----- error-free transformations ---------------------------------------------
+
+inline DDouble_t DDouble_t::TwoSum(const double a, const double b)
+{
+   // Returns a + b exactly, as the rounded sum plus its rounding error.
+
+   double s = a + b;
+   double bb = s - a;
+   return DDouble_t(s, (a - (s - bb)) + (b - bb));
+}
+
+inline DDouble_t DDouble_t::QuickTwoSum(const double a, const double b)
+{
+   // Same as TwoSum, but only valid if |a| >= |b|.
+
+   double s = a + b;
+   return DDouble_t(s, b - (s - a));
+}
+
+inline DDouble_t DDouble_t::TwoProd(const double a, const double b)
+{
+   // Returns a * b exactly, as the rounded product plus its rounding
+   // error, using a fused multiply-add where the hardware has one.
+
+   double p = a * b;
+#ifdef __FMA__
+   return DDouble_t(p, std::fma(a, b, -p));
+#else
+   const double split = 134217729.0;   // 2^27 + 1
+   double t = split * a;
+   double ahi = t - (t - a);
+   double alo = a - ahi;
+   t = split * b;
+   double bhi = t - (t - b);
+   double blo = b - bhi;
+   return DDouble_t(p, ((ahi * bhi - p) + ahi * blo + alo * bhi) + alo * blo);
+#endif
+}
+
+//----- arithmetic -------------------------------------------------------------
+
+inline DDouble_t operator+(const DDouble_t &a, const DDouble_t &b)
+{
+   DDouble_t s = DDouble_t::TwoSum(a.hi, b.hi);
+   DDouble_t t = DDouble_t::TwoSum(a.lo, b.lo);
+   s.lo += t.hi;
+   s = DDouble_t::QuickTwoSum(s.hi, s.lo);
+   s.lo += t.lo;
+   return DDouble_t::QuickTwoSum(s.hi, s.lo);
+}
+
+inline DDouble_t operator-(const DDouble_t &a, const DDouble_t &b)
+{
+   return a + (-b);
+}
+
+inline DDouble_t operator*(const DDouble_t &a, const DDouble_t &b)
+{
+   DDouble_t p = DDouble_t::TwoProd(a.hi, b.hi);
+   p.lo += a.hi * b.lo + a.lo * b.hi;
+   return DDouble_t::QuickTwoSum(p.hi, p.lo);
+}
+
+inline DDouble_t operator/(const DDouble_t &a, const DDouble_t &b)
+{
+   double q1 = a.hi / b.hi;
+   DDouble_t r = a - b * DDouble_t(q1);
+   double q2 = r.hi / b.hi;
+   r -= b * DDouble_t(q2);
+   double q3 = r.hi / b.hi;
+   return DDouble_t::QuickTwoSum(q1, q2) + DDouble_t(q3);
+}
+
+inline DDouble_t &DDouble_t::operator+=(const DDouble_t &b)
+{
+   return *this = *this + b;
+}
+
+inline DDouble_t &DDouble_t::operator-=(const DDouble_t &b)
+{
+   return *this = *this - b;
+}
+
+inline DDouble_t &DDouble_t::operator*=(const DDouble_t &b)
+{
+   return *this = *this * b;
+}
+
+inline DDouble_t &DDouble_t::operator/=(const DDouble_t &b)
+{
+   return *this = *this / b;
+}
+
+inline bool operator==(const DDouble_t &a, const DDouble_t &b)
+{
+   return a.hi == b.hi && a.lo == b.lo;
+}
+
+inline bool operator!=(const DDouble_t &a, const DDouble_t &b)
+{
+   return a.hi != b.hi || a.lo != b.lo;
+}
+
+inline bool operator<(const DDouble_t &a, const DDouble_t &b)
+{
+   return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+}
+
+inline bool operator>(const DDouble_t &a, const DDouble_t &b)
+{
+   return b < a;
+}
+
+inline bool operator<=(const DDouble_t &a, const DDouble_t &b)
+{
+   return !(b < a);
+}
+
+inline bool operator>=(const DDouble_t &a, const DDouble_t &b)
+{
+   return !(a < b);
+}
+
+// Overloads of the operators for a DDouble_t mixed with each of the
+// built-in arithmetic types, which would otherwise be ambiguous between
+// the DDouble_t operators and the built-in ones applied to double(a).
+
+#define DDOUBLE_MIXED_OPERATOR(OP, RESULT, TYPE)                        \
+inline RESULT operator OP(const DDouble_t &a, const TYPE b)             \
+{ return a OP DDouble_t(b); }                                           \
+inline RESULT operator OP(const TYPE a, const DDouble_t &b)             \
+{ return DDouble_t(a) OP b; }
+
+#define DDOUBLE_MIXED_OPERATORS(TYPE)                                   \
+DDOUBLE_MIXED_OPERATOR(+, DDouble_t, TYPE)                              \
+DDOUBLE_MIXED_OPERATOR(-, DDouble_t, TYPE)                              \
+DDOUBLE_MIXED_OPERATOR(*, DDouble_t, TYPE)                              \
+DDOUBLE_MIXED_OPERATOR(/, DDouble_t, TYPE)                              \
+DDOUBLE_MIXED_OPERATOR(==, bool, TYPE)                                  \
+DDOUBLE_MIXED_OPERATOR(!=, bool, TYPE)                                  \
+DDOUBLE_MIXED_OPERATOR(<, bool, TYPE)                                   \
+DDOUBLE_MIXED_OPERATOR(>, bool, TYPE)                                   \
+DDOUBLE_MIXED_OPERATOR(<=, bool, TYPE)                                  \
+DDOUBLE_MIXED_OPERATOR(>=, bool, TYPE)
+
+DDOUBLE_MIXED_OPERATORS(double)
+DDOUBLE_MIXED_OPERATORS(float)
+DDOUBLE_MIXED_OPERATORS(int)
+DDOUBLE_MIXED_OPERATORS(unsigned int)
+DDOUBLE_MIXED_OPERATORS(long)
+DDOUBLE_MIXED_OPERATORS(unsigned long)
+DDOUBLE_MIXED_OPERATORS(long long)
+DDOUBLE_MIXED_OPERATORS(unsigned long long)
+DDOUBLE_MIXED_OPERATORS(long double)
+
+#undef DDOUBLE_MIXED_OPERATORS
+#undef DDOUBLE_MIXED_OPERATOR
+
+//----- elementary functions ---------------------------------------------------
+
+const DDouble_t DDouble_pi(3.141592653589793116e+00, 1.224646799147353207e-16);
+const DDouble_t DDouble_ln2(6.931471805599452862e-01, 2.319046813846299558e-17);
+const double DDouble_eps = 4.93038065763132e-32;   // 2^-104
+
+inline DDouble_t fabs(const DDouble_t &a)
+{
+   return (a.hi < 0)? -a : a;
+}
+
+inline DDouble_t abs(const DDouble_t &a)
+{
+   return fabs(a);
+}
+
+inline DDouble_t floor(const DDouble_t &a)
+{
+   double hi = std::floor(a.hi);
+   if (hi == a.hi)
+      return DDouble_t::QuickTwoSum(hi, std::floor(a.lo));
+   return DDouble_t(hi);
+}
+
+inline DDouble_t ldexp(const DDouble_t &a, const int n)
+{
+   return DDouble_t(std::ldexp(a.hi, n), std::ldexp(a.lo, n));
+}
+
+inline DDouble_t sqrt(const DDouble_t &a)
+{
+   // One Newton step from the double precision square root (Karp).
+
+   if (a.hi <= 0)
+      return DDouble_t(std::sqrt(a.hi));
+   double x = 1 / std::sqrt(a.hi);
+   double ax = a.hi * x;
+   return DDouble_t(ax) + (a - DDouble_t::TwoProd(ax, ax)).hi * (x * 0.5);
+}
+
+inline DDouble_t exp(const DDouble_t &a)
+{
+   // Reduces the argument to r = (a - m ln2)/512, sums the Taylor series
+   // for exp(r) - 1, and then squares the result 9 times.
+
+   if (a.hi > 709.)
+      return DDouble_t(HUGE_VAL);
+   if (a.hi < -745.)
+      return DDouble_t(0.);
+   double m = std::floor(a.hi / DDouble_ln2.hi + 0.5);
+   DDouble_t r = ldexp(a - DDouble_ln2 * m, -9);
+   DDouble_t s = r;
+   DDouble_t term = r;
+   for (int n=2; n < 20; n++) {
+      term *= r / double(n);
+      s += term;
+      if (std::fabs(term.hi) < DDouble_eps * std::fabs(s.hi))
+         break;
+   }
+   for (int i=0; i < 9; i++)
+      s = s * (s + 2.);
+   return ldexp(s + 1., (int)m);
+}
+
+inline DDouble_t log(const DDouble_t &a)
+{
+   // One Newton step x + a exp(-x) - 1 from the double precision log.
+
+   if (a.hi <= 0)
+      return DDouble_t(std::log(a.hi));
+   DDouble_t x(std::log(a.hi));
+   return x + a * exp(-x) - 1.;
+}
+
+inline void sincos(const DDouble_t &a, DDouble_t *s, DDouble_t *c)
+{
+   // Computes sin(a) and cos(a) together, by reducing the argument to
+   // |t| <= pi/4 modulo pi/2 and summing the Taylor series in t.
+
+   double j = std::floor(a.hi / (DDouble_pi.hi / 2) + 0.5);
+   DDouble_t t = a - ldexp(DDouble_pi, -1) * j;
+   DDouble_t t2 = t * t;
+   DDouble_t sint = t;
+   DDouble_t cost = 1.;
+   DDouble_t term = t;
+   for (int n=3; n < 40; n += 2) {
+      term *= -t2 / double((n-1) * n);
+      sint += term;
+      if (std::fabs(term.hi) < DDouble_eps)
+         break;
+   }
+   term = 1.;
+   for (int n=2; n < 40; n += 2) {
+      term *= -t2 / double((n-1) * n);
+      cost += term;
+      if (std::fabs(term.hi) < DDouble_eps)
+         break;
+   }
+   int quadrant = (int)(j - 4 * std::floor(j / 4));
+   switch (quadrant) {
+    case 0:
+      *s = sint;
+      *c = cost;
+      break;
+    case 1:
+      *s = cost;
+      *c = -sint;
+      break;
+    case 2:
+      *s = -sint;
+      *c = -cost;
+      break;
+    default:
+      *s = -cost;
+      *c = sint;
+   }
+}
+
+inline DDouble_t sin(const DDouble_t &a)
+{
+   DDouble_t s, c;
+   sincos(a, &s, &c);
+   return s;
+}
+
+inline DDouble_t cos(const DDouble_t &a)
+{
+   DDouble_t s, c;
+   sincos(a, &s, &c);
+   return c;
+}
+
+inline DDouble_t atan2(const DDouble_t &y, const DDouble_t &x)
+{
+   // One Newton step on sin(z) = y/r or cos(z) = x/r from the double
+   // precision angle, whichever is better conditioned.
+
+   if (x.hi == 0 && y.hi == 0)
+      return DDouble_t(0.);
+   DDouble_t z(std::atan2(y.hi, x.hi));
+   DDouble_t r = sqrt(x * x + y * y);
+   DDouble_t s, c;
+   sincos(z, &s, &c);
+   if (std::fabs(x.hi) > std::fabs(y.hi))
+      return z + (y / r - s) / c;
+   else
+      return z - (x / r - c) / s;
+}
+
+inline DDouble_t atan2(const DDouble_t &y, const double x)
+{
+   return atan2(y, DDouble_t(x));
+}
+
+inline DDouble_t sinh(const DDouble_t &a)
+{
+   if (std::fabs(a.hi) < 1e-3) {
+      DDouble_t a2 = a * a;
+      return a * (1. + a2 / 6. * (1. + a2 / 20. * (1. + a2 / 42.
+                   * (1. + a2 / 72. * (1. + a2 / 110.)))));
+   }
+   DDouble_t e = exp(a);
+   return ldexp(e - 1. / e, -1);
+}
+
+inline DDouble_t cosh(const DDouble_t &a)
+{
+   DDouble_t e = exp(a);
+   return ldexp(e + 1. / e, -1);
+}
+
+inline DDouble_t asinh(const DDouble_t &a)
+{
+   if (a.hi < 0)
+      return -asinh(-a);
+   return log(a + sqrt(a * a + 1.));
+}
+
+inline DDouble_t pow(const DDouble_t &a, const int n)
+{
+   // Integer powers by repeated squaring.
+
+   DDouble_t result = 1.;
+   DDouble_t base = a;
+   for (int m = (n < 0)? -n : n; m > 0; m >>= 1) {
+      if (m & 1)
+         result *= base;
+      base *= base;
+   }
+   return (n < 0)? 1. / result : result;
+}
+
+inline DDouble_t pow(const DDouble_t &a, const DDouble_t &b)
+{
+   if (b.lo == 0 && b.hi == std::floor(b.hi) && std::fabs(b.hi) < 1024)
+      return pow(a, (int)b.hi);
+   return exp(b * log(a));
+}
+
+inline DDouble_t pow(const DDouble_t &a, const double b)
+{
+   return pow(a, DDouble_t(b));
+}
+
+inline std::ostream &operator<<(std::ostream &out, const DDouble_t &a)
+{
+   return out << (long double)a;
+}
+
+inline std::istream &operator>>(std::istream &in, DDouble_t &a)
+{
+   long double x;
+   in >> x;
+   a = DDouble_t(x);
+   return in;
+}
+
+#endif
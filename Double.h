@@ -1,6 +1,24 @@
 #ifndef ROOT_LDouble_t
 #define ROOT_LDouble_t 1
 
+// LDouble_t is the scalar type used for all of the arithmetic in the
+// package.  It is the x87 long double unless the package is built with
+// DIRACXX_DOUBLE_DOUBLE defined, in which case it is the double-double
+// type DDouble_t, see DDouble.h, or with DIRACXX_FLOAT128 defined, in
+// which case it is the quad-precision type QDouble_t, see QDouble.h, or
+// with DIRACXX_DOUBLE defined, in which case it is plain double, for the
+// fast first pass of the adaptive precision mode, see precision.cxx.
+
+#if defined DIRACXX_DOUBLE_DOUBLE
+#include "DDouble.h"
+typedef DDouble_t LDouble_t;
+#elif defined DIRACXX_FLOAT128
+#include "QDouble.h"
+typedef QDouble_t LDouble_t;
+#elif defined DIRACXX_DOUBLE
+typedef double LDouble_t;
+#else
 typedef long double LDouble_t;
+#endif
 
 #endif
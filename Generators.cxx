@@ -0,0 +1,605 @@
+//
+// Generators.cxx
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// The cross sections, kinematics and sampling of the e+e- pair
+// generators in Pairs.C and Triplets.C, see Generators.h.
+
+#include <cmath>
+
+#include "Generators.h"
+#include "Complex.h"
+#include "TPhoton.h"
+#include "TLepton.h"
+#include "TLorentzBoost.h"
+#include "TCrossSection.h"
+#include "TAmplitudeTensor.h"
+#include "constants.h"
+#include "sqr.h"
+#include "Profiler.h"
+
+#include <TRandom.h>
+
+//#define H_DIPOLE_FORM_FACTOR 1
+
+Int_t PairsKinematics(Double_t *var, Double_t *par,
+                      TPhoton &gIn, TLepton &eOut, TLepton &pOut,
+                      TThreeVectorReal &qRecoil)
+{
+   // Solves for the momenta of all particles in the lab frame from the
+   // kinematic variables in var,par (see Pairs below), in the limit of a
+   // high mass target, and stores them in gIn,eOut,pOut, and the momentum
+   // transferred to the target in qRecoil.  Returns 0 if there is no
+   // solution, else 1.
+
+   LDouble_t kin=par[0];
+   LDouble_t Epos=par[1]=var[0];
+   LDouble_t phi12=par[2];
+   LDouble_t Mpair=par[3];
+   LDouble_t qR2=par[4];
+   LDouble_t phiR=par[5];
+
+   // Solve for the rest of the kinematics, limit of high mass target
+   LDouble_t qR=sqrt(qR2);
+   LDouble_t qmin=kin-sqrt(sqr(kin)-sqr(Mpair));
+   LDouble_t costhetaR=(qR2+sqr(Mpair))/(2*kin*qR);
+   if (costhetaR > 1) {
+      // std::cout << "no kinematic solution because costhetaR > 1" << std::endl;
+      return 0;
+   }
+   LDouble_t sinthetaR=sqrt(1-sqr(costhetaR));
+   qRecoil = TThreeVectorReal(qR*sinthetaR*cos(phiR),
+                              qR*sinthetaR*sin(phiR),
+                              qR*costhetaR);
+
+   if (qRecoil[3] < qmin) {
+      // std::cout << "no kinematic solution because qRecoil[3] < qmin" << std::endl;
+      return 0;
+   }
+
+   gIn.SetMom(TThreeVectorReal(0,0,kin));
+   LDouble_t pStar2=sqr(Mpair/2)-sqr(mElectron);
+   if (pStar2 < 0) {
+      // std::cout << "no kinematic solution because pStar2 < 0" << std::endl;
+      return 0;
+   }
+   LDouble_t pStar=sqrt(pStar2);
+   LDouble_t p12mag=sqrt(sqr(kin)-sqr(Mpair));
+   LDouble_t costhetastar=(Epos-kin/2)*Mpair/(pStar*p12mag);
+   if (fabs(costhetastar) > 1) {
+      // std::cout << "no kinematic solution because costhetastar < 1" << std::endl;
+      return 0;
+   }
+   LDouble_t sinthetastar=sqrt(1-sqr(costhetastar));
+   TThreeVectorReal k12(pStar*sinthetastar*cos(phi12),
+                        pStar*sinthetastar*sin(phi12),
+                        pStar*costhetastar);
+   TFourVectorReal p1(Mpair/2,k12);
+   TLorentzBoost toLab(qRecoil[1]/kin,qRecoil[2]/kin,(qRecoil[3]-kin)/kin);
+   p1.Boost(toLab);
+   pOut.SetMom(p1);
+   TThreeVectorReal p2(gIn.Mom()-qRecoil-p1);
+   eOut.SetMom(p2);
+
+   return 1;
+}
+
+Double_t PairsPolarized(Double_t *var, Double_t *par,
+                        const TThreeVectorReal &pol,
+                        Int_t *helicities, Double_t u,
+                        TAmplitudeTensor *amp)
+{
+   // Same as Pairs, but for an incident photon with polarization pol
+   // (see TPhoton::SetPol for the encoding).  If helicities is not null,
+   // the final e-,e+ helicities are also chosen in proportion to |M|^2
+   // using the uniform random number u, from the same evaluation of the
+   // amplitudes, and returned packed in *helicities as 2*h(e-) + h(e+),
+   // with h=0 for helicity +1/2 and h=1 for -1/2.  If amp is not null,
+   // it receives the amplitudes for legs (gIn,eOut,pOut), with the form
+   // factor included in the kinematical factor, so that contracting it
+   // with the polarizations used here gives back the returned value.
+   // The amplitudes are only set if the kinematics are physical.
+
+   DIRACXX_PROFILE_SCOPE("PairsPolarized");
+   DIRACXX_PROFILE_SECTION("kinematics");
+   TPhoton gIn;
+   TLepton eOut(mElectron), pOut(mElectron);
+   TThreeVectorReal qRecoil;
+   if (PairsKinematics(var,par,gIn,eOut,pOut,qRecoil) == 0) {
+      return 0;
+   }
+   DIRACXX_PROFILE_SECTION("cross section");
+   return PairsCrossSection(gIn,eOut,pOut,qRecoil,pol,helicities,u,amp);
+}
+
+Double_t PairsCrossSection(TPhoton &gIn, TLepton &eOut, TLepton &pOut,
+                           const TThreeVectorReal &qRecoil,
+                           const TThreeVectorReal &pol,
+                           Int_t *helicities, Double_t u,
+                           TAmplitudeTensor *amp)
+{
+   // Same as PairsPolarized, but for the momenta already solved for by
+   // PairsKinematics, so that a caller that needs the momenta as well as
+   // the cross section solves the kinematics only once.  The polarizations
+   // of gIn,eOut,pOut are overwritten.
+
+   LDouble_t kin=gIn.Mom()[0];
+   LDouble_t Epos=pOut.Mom()[0];
+   LDouble_t Eele=kin-Epos;
+
+   // Set the initial,final polarizations
+   gIn.SetPol(pol);
+   eOut.AllPol();
+   pOut.AllPol();
+
+   // Multiply the basic cross section by the atomic form factor, asumed to be 9Be
+   const LDouble_t Z=4;
+   const LDouble_t Fff=FFatomic(qRecoil.Length());
+   LDouble_t result;
+   if (helicities || amp) {
+      TAmplitudeTensor tensor;
+      TAmplitudeTensor &a = (amp)? *amp : tensor;
+      TCrossSection::PairProductionAmplitude(gIn,eOut,pOut,a);
+      a.SetKinFactor(a.KinFactor()*sqr(Z*(1-Fff)));
+      const TPauliMatrix *sdm[3] = {&gIn.SDM(), 0, 0};
+      if (helicities) {
+         Int_t index = a.Sample(sdm, (1 << 1) + (1 << 2), u, &result);
+         *helicities = (index < 0)? -1 : index & 3;
+      }
+      else {
+         result = a.Contract(sdm);
+      }
+   }
+   else {
+      result = TCrossSection::PairProduction(gIn,eOut,pOut);
+      result *= sqr(Z*(1-Fff));
+   }
+   return (Double_t)result;
+
+   // The unpolarized Bethe-Heitler cross section is given here for comparison
+   LDouble_t delta=136*mElectron/pow(Z,0.33333) * kin/(Eele*Epos);
+   LDouble_t aCoul=sqr(alphaQED*Z);
+   LDouble_t fCoul=aCoul*(1/(1+aCoul)+0.20206-0.0369*aCoul
+                       +0.0083*pow(aCoul,2)-0.002*pow(aCoul,3));
+   LDouble_t xsi=log(1440/pow(Z,0.66667))/(log(183/pow(Z,0.33333)-fCoul));
+   LDouble_t FofZ=(8./3.)*log(Z) + ((kin < 0.05)? (LDouble_t)0 : 8*fCoul);
+   LDouble_t Phi1=20.867-3.242*delta+0.625*sqr(delta);
+   LDouble_t Phi2=20.209-1.930*delta-0.086*sqr(delta);
+   LDouble_t Phi0=21.12-4.184*log(delta+0.952);
+   if (delta > 1) {
+      Phi1=Phi2=Phi0;
+   }
+   result = hbarcSqr/sqr(mElectron)*pow(alphaQED,3)/kin
+            * Z*(Z+xsi)
+            * (
+                 (sqr(Eele)+sqr(Epos))/sqr(kin)*(Phi1-FofZ/2)
+                 + (2./3.)*(Eele*Epos)/sqr(kin)*(Phi2-FofZ/2)
+              );
+}
+
+Double_t Pairs(Double_t *var, Double_t *par)
+{
+   return PairsPolarized(var,par,TThreeVectorReal(1,0,0));
+}
+
+Double_t PairsSample(Double_t kin, TRandom &random_gen, Double_t *var)
+{
+   // Generates a random set of kinematic variables var = {Epos, phi12,
+   // Mpair, qR2, phiR} for incident photon energy kin, using the same
+   // layout as par[1..5] in Pairs.  The return value is the weight of the
+   // generated point, which includes the Jacobian from (d^3 qR dphi+ dE+)
+   // to the sampled variables.
+
+   DIRACXX_PROFILE_SCOPE("PairsSample");
+   Double_t &Epos = var[0];
+   Double_t &phi12 = var[1];
+   Double_t &Mpair = var[2];
+   Double_t &qR2 = var[3];
+   Double_t &phiR = var[4];
+   LDouble_t weight = 1;
+
+   // generate Epos uniform on [0,E0]
+   Epos = random_gen.Uniform(kin);
+   weight *= kin;
+
+   // generate phi12 uniform on [0,2pi]
+   phi12 = random_gen.Uniform((Double_t)(2*PI_));
+   weight *= 2*PI_;
+
+   // generate phiR uniform on [0,2pi]
+   phiR = random_gen.Uniform((Double_t)(2*PI_));
+   weight *= 2*PI_;
+
+#ifdef OLD_WEIGHTING
+
+   // generate Mpair with weight (M0/M)^3
+   LDouble_t M0=2*mElectron;
+   Mpair = M0/sqrt(random_gen.Uniform(1.));
+   weight *= pow(Mpair,3)/(2*M0*M0);
+
+   // generate qR2 with weight 1/(q02 + qR2)^2
+   LDouble_t q02=sqr(5e-5); // 50 keV/c cutoff parameter
+   LDouble_t u=random_gen.Uniform(1);
+   qR2 = q02*(1-u)/(u+1e-50);
+   weight *= sqr(qR2+q02)/q02;
+
+#else
+
+   // generate Mpair with weight (1/M) / (Mcut^2 + M^2)
+   LDouble_t Mmin=2*mElectron;
+   LDouble_t Mcut=5e-3; // 5 MeV cutoff parameter
+   LDouble_t um0 = 1+sqr(Mcut/Mmin);
+   LDouble_t um = pow(um0,random_gen.Uniform(1));
+   Mpair = (Double_t)(Mcut/sqrt(um-1));
+   weight *= Mpair*(sqr(Mcut)+sqr(Mpair))
+             *log(um0)/(2*sqr(Mcut));
+
+   // generate qR^2 with weight (1/qR^2) / sqrt(qRcut^2 + qR^2)
+   LDouble_t qRmin = sqr(Mpair)/(2*kin);
+   LDouble_t qRcut = 1e-3; // 1 MeV/c cutoff parameter
+   LDouble_t uq0 = qRmin/(qRcut+sqrt(sqr(qRcut)+sqr(qRmin)));
+   LDouble_t uq = pow(uq0,random_gen.Uniform(1));
+   qR2 = (Double_t)sqr(2*qRcut*uq/(1-sqr(uq)));
+   weight *= qR2*sqrt(1+qR2/sqr(qRcut))
+             *(-2*log(uq0));
+
+#endif
+
+   // overall measure Jacobian factor
+   weight *= Mpair/(2*kin);
+
+   return (Double_t)weight;
+}
+
+Int_t PairsStream_fill(PairsStream_event_t *events, Int_t n, Double_t kin,
+                       TRandom &random_gen, Bool_t sampleHelicities)
+{
+   // Fills events[0..n-1] with pair events generated as in genPairs for
+   // incident photon energy kin, drawing all random numbers from
+   // random_gen, and keeping only the events that genPairs would write
+   // to its tree.  Returns the total number of points sampled.  This is
+   // safe to call from several threads at once, each with its own
+   // random_gen and events.
+
+   Int_t total = 0;
+   Int_t trials = 0;
+   TPhoton gIn;
+   TLepton eOut(mElectron), pOut(mElectron);
+   TThreeVectorReal qRecoil;
+   for (Int_t i=0; i < n; ) {
+      PairsStream_event_t &event = events[i];
+      ++trials;
+      event.E0 = kin;
+      event.weight = PairsSample(event.E0, random_gen, &event.Epos);
+
+      Double_t *par=&event.E0;
+      Double_t *var=&event.Epos;
+      event.hel = -1;
+      Double_t u = (sampleHelicities)? random_gen.Uniform(1) : 0;
+      if (PairsKinematics(var,par,gIn,eOut,pOut,qRecoil) == 0) {
+         continue;
+      }
+      event.diffXS = PairsCrossSection(gIn,eOut,pOut,qRecoil,
+                                       TThreeVectorReal(1,0,0),
+                                       (sampleHelicities)? &event.hel : 0,
+                                       u);
+      event.weightedXS = event.diffXS*event.weight;
+      if (!(event.weightedXS > 0)) {
+         continue;
+      }
+
+      for (Int_t mu=0; mu < 4; mu++) {
+         event.eOut[mu] = (Double_t)eOut.Mom()[mu];
+         event.pOut[mu] = (Double_t)pOut.Mom()[mu];
+      }
+      for (Int_t j=0; j < 3; j++) {
+         event.qRecoil[j] = (Double_t)qRecoil[j+1];
+      }
+      event.trials = trials;
+      total += trials;
+      trials = 0;
+      ++i;
+   }
+   return total;
+}
+
+Int_t TripletsKinematics(Double_t *var, Double_t *par,
+                         TPhoton &g0, TLepton &e0, TLepton &e1,
+                         TLepton &e2, TLepton &e3)
+{
+   // Solves for the momenta of all particles in the lab frame from the
+   // kinematic variables in var,par (see Triplets below), and stores them
+   // in g0,e0,e1,e2,e3.  Returns 0 if there is no solution, else 1.
+
+   DIRACXX_PROFILE_SCOPE("TripletsKinematics");
+   LDouble_t kin=par[0];
+   LDouble_t Epos=par[1]=var[0];
+   LDouble_t phi12=par[2];
+   LDouble_t Mpair=par[3];
+   LDouble_t qR2=par[4];
+   LDouble_t phiR=par[5];
+
+   // Solve for the 4-vector qR
+   if (kin < 0 || Epos < mElectron || Mpair < 2 * mElectron || qR2 < 0) {
+      // cout << "no kinematic solution, input parameters out of range"
+      //      << endl;
+      return 0;
+   }
+   LDouble_t qR=sqrt(qR2);
+   LDouble_t E3=sqrt(qR2+sqr(mElectron));
+   LDouble_t costhetaR=(sqr(Mpair)/2 + (kin+mElectron)*(E3-mElectron))/(kin*qR);
+   if (fabs(costhetaR) > 1) {
+      // cout << "no kinematic solution because |costhetaR| > 1" << endl;
+      return 0;
+   }
+   LDouble_t qRperp=qR*sqrt(1-sqr(costhetaR));
+   LDouble_t qRlong=qR*costhetaR;
+   TFourVectorReal q3(E3,qRperp*cos(phiR),qRperp*sin(phiR),qRlong);
+
+   // Solve for the c.m. momentum of e+ in the pair 1,2 rest frame
+   LDouble_t k12star2=sqr(Mpair/2)-sqr(mElectron);
+   if (k12star2 < 0) {
+      // cout << "no kinematic solution because k12star2 < 0" << endl;
+      return 0;
+   }
+   LDouble_t k12star=sqrt(k12star2);
+   LDouble_t E12=kin+mElectron-E3;
+   if (E12 < Mpair) {
+      // cout << "no kinematic solution because E12 < Mpair" << endl;
+      return 0;
+   }
+   LDouble_t q12mag=sqrt(sqr(E12)-sqr(Mpair));
+   LDouble_t costhetastar=(Epos-E12/2)*Mpair/(k12star*q12mag);
+   if (Epos < mElectron) {
+      // cout << "no kinematic solution because Epos < mElectron" << endl;
+      return 0;
+   }
+   else if (Epos > E12 - mElectron) {
+      // cout << "no kinematic solution because Epos > E12 - mElectron"
+      //      << endl;
+      return 0;
+   }
+   else if (fabs(costhetastar) > 1) {
+      // cout << "no kinematic solution because |costhetastar| > 1" << endl;
+      return 0;
+   }
+   LDouble_t sinthetastar=sqrt(1-sqr(costhetastar));
+   TThreeVectorReal k12(k12star*sinthetastar*cos(phi12),
+                        k12star*sinthetastar*sin(phi12),
+                        k12star*costhetastar);
+   TFourVectorReal q1(Mpair/2,-k12);
+   TFourVectorReal q2(Mpair/2,k12);
+   TLorentzBoost pairCMtolab(q3[1]/E12,q3[2]/E12,(q3[3]-kin)/E12);
+   q1.Boost(pairCMtolab);
+   q2.Boost(pairCMtolab);
+
+   // To avoid double-counting, return zero if recoil electron
+   // momentum is greater than the momentum of the pair electron.
+   if (q2.Length() < qR) {
+      // cout << "recoil/pair electrons switched, returning 0" << endl;
+      return 0;
+   }
+
+   // Define the particle objects
+   g0.SetMom(TThreeVectorReal(0,0,kin));
+   e0.SetMom(TThreeVectorReal(0,0,0));
+   e1.SetMom(q1);
+   e2.SetMom(q2);
+   e3.SetMom(q3);
+
+   return 1;
+}
+
+Double_t TripletsPolarized(Double_t *var, Double_t *par,
+                           const TThreeVectorReal &pol,
+                           Int_t *helicities, Double_t u,
+                           TAmplitudeTensor *amp)
+{
+   // Same as Triplets, but for an incident photon with polarization pol
+   // (see TPhoton::SetPol for the encoding).  If helicities is not null,
+   // the final e+,e-,e- helicities are also chosen in proportion to |M|^2
+   // using the uniform random number u, from the same evaluation of the
+   // amplitudes, and returned packed in *helicities as 4*h(e+) + 2*h(e-)
+   // + h(recoil e-), with h=0 for helicity +1/2 and h=1 for -1/2.  If amp
+   // is not null, it receives the amplitudes for legs (g0,e0,e1,e2,e3),
+   // with the form factor included in the kinematical factor, as for
+   // PairsPolarized.  The amplitudes are only set if the kinematics are
+   // physical.
+
+   DIRACXX_PROFILE_SCOPE("TripletsPolarized");
+   DIRACXX_PROFILE_SECTION("kinematics");
+   TPhoton g0;
+   TLepton e0(mElectron),e1(mElectron),e2(mElectron),e3(mElectron);
+   if (TripletsKinematics(var,par,g0,e0,e1,e2,e3) == 0) {
+      return 0;
+   }
+   DIRACXX_PROFILE_SECTION("cross section");
+   return TripletsCrossSection(g0,e0,e1,e2,e3,pol,helicities,u,amp);
+}
+
+Double_t TripletsCrossSection(TPhoton &g0, TLepton &e0, TLepton &e1,
+                              TLepton &e2, TLepton &e3,
+                              const TThreeVectorReal &pol,
+                              Int_t *helicities, Double_t u,
+                              TAmplitudeTensor *amp)
+{
+   // Same as TripletsPolarized, but for the momenta already solved for by
+   // TripletsKinematics, as for PairsCrossSection.  The polarizations of
+   // g0,e0,e1,e2,e3 are overwritten.
+
+   // Set the initial, final polarizations
+   g0.SetPol(pol);
+   e0.SetPol(TThreeVectorReal(0,0,0));
+   e1.AllPol();
+   e2.AllPol();
+   e3.AllPol();
+
+   LDouble_t result;
+   LDouble_t FF = FFatomic(e3.Mom().Length());
+   if (helicities || amp) {
+      TAmplitudeTensor tensor;
+      TAmplitudeTensor &a = (amp)? *amp : tensor;
+      TCrossSection::TripletProductionAmplitude(g0,e0,e1,e2,e3,a);
+      a.SetKinFactor(a.KinFactor() * (1 - FF*FF));
+      const TPauliMatrix *sdm[5] = {&g0.SDM(), &e0.SDM(), 0, 0, 0};
+      if (helicities) {
+         Int_t index = a.Sample(sdm, (1 << 2) + (1 << 3) + (1 << 4), u,
+                                &result);
+         *helicities = (index < 0)? -1 : index & 7;
+      }
+      else {
+         result = a.Contract(sdm);
+      }
+      return (Double_t)result;
+   }
+   result = TCrossSection::TripletProduction(g0,e0,e1,e2,e3);
+   return (Double_t)(result * (1 - FF*FF));
+}
+
+Double_t Triplets(Double_t *var, Double_t *par)
+{
+   return TripletsPolarized(var,par,TThreeVectorReal(1,0,0));
+}
+
+Double_t TripletsSample(Double_t kin, const Double_t *urand, Double_t *var)
+{
+   // Maps the 5 uniform random numbers in urand onto the kinematic
+   // variables var = {Epos, phi12, Mpair, qR2, phiR} for incident photon
+   // energy kin, using the same layout as par[1..5] in Triplets.  The
+   // return value is the weight of the generated point, which includes
+   // the Jacobian from (d^3 qR dphi+ dE+) to the sampled variables.
+
+   DIRACXX_PROFILE_SCOPE("TripletsSample");
+   Double_t &Epos = var[0];
+   Double_t &phi12 = var[1];
+   Double_t &Mpair = var[2];
+   Double_t &qR2 = var[3];
+   Double_t &phiR = var[4];
+   LDouble_t weight = 1;
+
+   // generate E+ uniform on [0,E0]
+   Epos = urand[2] * kin;
+   weight *= kin;
+
+   // generate phi12 uniform on [0,2pi]
+   phi12 = (Double_t)(urand[3] * 2*PI_);
+   weight *= 2*PI_;
+
+   // generate phiR uniform on [0,2pi]
+   phiR = (Double_t)(urand[4] * 2*PI_);
+   weight *= 2*PI_;
+
+   // generate Mpair with weight (1/M) / (Mcut^2 + M^2)
+   LDouble_t Mmin=2*mElectron;
+   LDouble_t Mcut=5e-3; // 5 MeV cutoff parameter
+   LDouble_t um0 = 1+sqr(Mcut/Mmin);
+   LDouble_t um = pow(um0, urand[0]);
+   Mpair = (Double_t)(Mcut/sqrt(um-1));
+   weight *= Mpair*(sqr(Mcut)+sqr(Mpair))
+             *log(um0)/(2*sqr(Mcut));
+
+   // generate qR^2 with weight (1/qR^2) / sqrt(qRcut^2 + qR^2)
+   LDouble_t qRmin = sqr(Mpair)/(2*kin);
+   LDouble_t qRcut = 1e-3; // 1 MeV/c cutoff parameter
+   LDouble_t uq0 = qRmin/(qRcut+sqrt(sqr(qRcut)+sqr(qRmin)));
+   LDouble_t uq = pow(uq0, urand[1]);
+   qR2 = (Double_t)sqr(2*qRcut*uq/(1-sqr(uq)));
+   weight *= qR2*sqrt(1+qR2/sqr(qRcut))
+             *(-2*log(uq0));
+
+   // overall measure Jacobian factor
+   weight *= Mpair/(2*kin);
+
+   return (Double_t)weight;
+}
+
+Int_t TripletsStream_fill(TripletsStream_event_t *events, Int_t n,
+                          Double_t kin, TRandom &random_gen,
+                          Bool_t sampleHelicities)
+{
+   // Fills events[0..n-1] with triplet events generated as in genTriplets
+   // for incident photon energy kin, drawing all random numbers from
+   // random_gen, and keeping only the events that genTriplets would write
+   // to its tree.  Returns the total number of points sampled.  The bias
+   // histogram set by set_bias2D_u0u1 is not used here, so that this is
+   // safe to call from several threads at once, each with its own
+   // random_gen and events.
+
+   Int_t total = 0;
+   Int_t trials = 0;
+   TPhoton g0;
+   TLepton e0(mElectron),e1(mElectron),e2(mElectron),e3(mElectron);
+   for (Int_t i=0; i < n; ) {
+      TripletsStream_event_t &event = events[i];
+      ++trials;
+      event.E0 = kin;
+      random_gen.RndmArray(5, event.urand);
+      event.weight = TripletsSample(event.E0, event.urand, &event.Epos);
+
+      Double_t *par=&event.E0;
+      Double_t *var=&event.Epos;
+      if (TripletsKinematics(var,par,g0,e0,e1,e2,e3) == 0) {
+         continue;
+      }
+      event.thetaR = (Double_t)e3.Mom().Theta();
+
+      event.hel = -1;
+      Double_t u = (sampleHelicities)? random_gen.Uniform(1) : 0;
+      event.diffXS = TripletsCrossSection(g0,e0,e1,e2,e3,
+                                          TThreeVectorReal(1,0,0),
+                                          (sampleHelicities)? &event.hel : 0,
+                                          u);
+      event.weightedXS = event.diffXS*event.weight;
+      if (!(event.weightedXS > 0)) {
+         continue;
+      }
+
+      for (Int_t mu=0; mu < 4; mu++) {
+         event.e1[mu] = (Double_t)e1.Mom()[mu];
+         event.e2[mu] = (Double_t)e2.Mom()[mu];
+         event.e3[mu] = (Double_t)e3.Mom()[mu];
+      }
+      event.trials = trials;
+      total += trials;
+      trials = 0;
+      ++i;
+   }
+   return total;
+}
+
+LDouble_t FFatomic(LDouble_t qR)
+{
+   // return the atomic form factor of 4Be normalized to unity
+   // at zero momentum transfer qR (GeV/c). Length is in Angstroms.
+
+#if H_DIPOLE_FORM_FACTOR
+
+   LDouble_t a0Bohr = 0.529177 / 1.97327e-6;
+   LDouble_t ff = 1 / pow(1 + pow(a0Bohr * qR, 2), 2);
+
+#else
+
+   double Z=4;
+
+   // parameterization given by online database at
+   // http://lampx.tugraz.at/~hadley/ss1/crystaldiffraction\
+   //      /atomicformfactors/formfactors.php
+
+   LDouble_t acoeff[] = {1.5919, 1.1278, 0.5391, 0.7029};
+   LDouble_t bcoeff[] = {43.6427, 1.8623, 103.483, 0.5420};
+   LDouble_t ccoeff[] = {0.0385};
+
+   LDouble_t q_invA = qR / 1.97327e-6;
+   LDouble_t ff = ccoeff[0];
+   for (int i=0; i < 4; ++i) {
+      ff += acoeff[i] * exp(-bcoeff[i] * pow(q_invA / (4 * M_PI), 2));
+   }
+   ff /= Z;
+
+#endif
+
+   return ff;
+}
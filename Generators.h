@@ -0,0 +1,121 @@
+//
+// Generators.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// The cross sections, kinematics and sampling of the e+e- pair
+// generators, for coherent production on an atom in Pairs.C and for
+// triplet production on a free electron in Triplets.C.  They are shared
+// by those macros, by precision.cxx and by the python iterators
+// PairsStream and TripletsStream, and are compiled into libDirac.so so
+// that the python bindings need not compile the macros, with their
+// graphics and tree output, into the library.  The kinematic variables
+// in var,par and the units of the cross sections are described at the
+// top of Pairs.C and Triplets.C.  None of these functions uses global
+// state, so they may be called from several threads at once.
+
+#ifndef DIRACXX_GENERATORS
+#define DIRACXX_GENERATORS
+
+#include "Double.h"
+#include "Rtypes.h"
+
+class TRandom;
+class TThreeVectorReal;
+class TPhoton;
+class TLepton;
+class TAmplitudeTensor;
+
+LDouble_t FFatomic(LDouble_t qR);
+
+Int_t PairsKinematics(Double_t *var, Double_t *par,
+                      TPhoton &gIn, TLepton &eOut, TLepton &pOut,
+                      TThreeVectorReal &qRecoil);
+Double_t PairsPolarized(Double_t *var, Double_t *par,
+                        const TThreeVectorReal &pol,
+                        Int_t *helicities=0, Double_t u=0,
+                        TAmplitudeTensor *amp=0);
+Double_t PairsCrossSection(TPhoton &gIn, TLepton &eOut, TLepton &pOut,
+                           const TThreeVectorReal &qRecoil,
+                           const TThreeVectorReal &pol,
+                           Int_t *helicities=0, Double_t u=0,
+                           TAmplitudeTensor *amp=0);
+Double_t Pairs(Double_t *var, Double_t *par);
+Double_t PairsSample(Double_t kin, TRandom &random_gen, Double_t *var);
+
+Int_t TripletsKinematics(Double_t *var, Double_t *par,
+                         TPhoton &g0, TLepton &e0, TLepton &e1,
+                         TLepton &e2, TLepton &e3);
+Double_t TripletsPolarized(Double_t *var, Double_t *par,
+                           const TThreeVectorReal &pol,
+                           Int_t *helicities=0, Double_t u=0,
+                           TAmplitudeTensor *amp=0);
+Double_t TripletsCrossSection(TPhoton &g0, TLepton &e0, TLepton &e1,
+                              TLepton &e2, TLepton &e3,
+                              const TThreeVectorReal &pol,
+                              Int_t *helicities=0, Double_t u=0,
+                              TAmplitudeTensor *amp=0);
+Double_t Triplets(Double_t *var, Double_t *par);
+Double_t TripletsSample(Double_t kin, const Double_t *urand, Double_t *var);
+
+struct PairsStream_event_t {
+
+   // One event from PairsStream_fill, with the same leading fields as the
+   // event_t of genPairs, followed by the lab momenta of the final e-,e+
+   // and the momentum transferred to the target.  The number of points
+   // sampled to obtain the event, including those rejected for having a
+   // weighted cross section of zero, is kept in trials so that the sum of
+   // weightedXS over the events divided by the sum of trials estimates
+   // the total cross section, as printed by genPairs.
+
+   Double_t E0;
+   Double_t Epos;
+   Double_t phi12;
+   Double_t Mpair;
+   Double_t qR2;
+   Double_t phiR;
+   Double_t diffXS;
+   Double_t weight;
+   Double_t weightedXS;
+   Double_t eOut[4];
+   Double_t pOut[4];
+   Double_t qRecoil[3];
+   Int_t hel;
+   Int_t trials;
+};
+
+Int_t PairsStream_fill(PairsStream_event_t *events, Int_t n, Double_t kin,
+                       TRandom &random_gen, Bool_t sampleHelicities=false);
+
+struct TripletsStream_event_t {
+
+   // One event from TripletsStream_fill, with the same leading fields as
+   // the event_t of genTriplets, followed by the lab momenta of the final
+   // e+ (e1), pair e- (e2) and recoil e- (e3), and the number of points
+   // sampled to obtain the event, as in PairsStream_event_t.
+
+   Double_t E0;
+   Double_t Epos;
+   Double_t phi12;
+   Double_t Mpair;
+   Double_t qR2;
+   Double_t phiR;
+   Double_t thetaR;
+   Double_t diffXS;
+   Double_t weight;
+   Double_t weightedXS;
+   Double_t urand[5];
+   Double_t e1[4];
+   Double_t e2[4];
+   Double_t e3[4];
+   Int_t hel;
+   Int_t trials;
+};
+
+Int_t TripletsStream_fill(TripletsStream_event_t *events, Int_t n,
+                          Double_t kin, TRandom &random_gen,
+                          Bool_t sampleHelicities=false);
+
+#endif
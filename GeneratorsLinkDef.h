@@ -0,0 +1,16 @@
+#pragma link C++ struct PairsStream_event_t;
+#pragma link C++ struct TripletsStream_event_t;
+
+#pragma link C++ function FFatomic;
+#pragma link C++ function PairsKinematics;
+#pragma link C++ function PairsPolarized;
+#pragma link C++ function PairsCrossSection;
+#pragma link C++ function Pairs;
+#pragma link C++ function PairsSample;
+#pragma link C++ function PairsStream_fill;
+#pragma link C++ function TripletsKinematics;
+#pragma link C++ function TripletsPolarized;
+#pragma link C++ function TripletsCrossSection;
+#pragma link C++ function Triplets;
+#pragma link C++ function TripletsSample;
+#pragma link C++ function TripletsStream_fill;
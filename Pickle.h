@@ -0,0 +1,327 @@
+//
+// Pickle.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Compact binary images of the value classes, for shipping particle
+// states between processes, as in the python pickle support and the
+// PackArray/UnpackArray methods in python_bindings.cxx.
+//
+// An image holds any number of objects of one class, and starts with
+// an 8-byte header
+//    byte 0     'D'
+//    byte 1     the code of the class, see Pickle_traits
+//    byte 2     the format of the components, 'd' for double, or the
+//               native LDouble_t, 'g' for long double, 'w' for the
+//               double-double DDouble_t and 'q' for QDouble_t
+//    byte 3     the size of one component in bytes
+//    bytes 4-7  the number of objects, as a native UInt_t
+// followed by the components of each object in turn.  These are the
+// real components of the vectors, the (real, imaginary) pairs of the
+// complex vectors, spinors and matrices, the matrices in row order,
+// and for TLepton the mass, four-momentum and spin density matrix, and
+// for TPhoton the four-momentum and spin density matrix.  Images in the
+// native format restore the objects exactly, while those in double
+// take half the space in the default build, for bulk transfers where
+// double precision is enough.  The images are in the byte order of the
+// machine that wrote them, and one in the native format can only be
+// read by a build with the same LDouble_t.  The x87 long double has 10
+// significant bytes in a slot of 12 or 16, and only those are copied
+// into the image, with the rest of the slot set to zero, so that the
+// same objects always give the same image.
+
+#ifndef DIRACXX_PICKLE
+#define DIRACXX_PICKLE
+
+#include <string.h>
+#include <float.h>
+
+#include "Double.h"
+#include "Complex.h"
+#include "TThreeVectorReal.h"
+#include "TThreeVectorComplex.h"
+#include "TFourVectorReal.h"
+#include "TFourVectorComplex.h"
+#include "TPauliSpinor.h"
+#include "TDiracSpinor.h"
+#include "TPauliMatrix.h"
+#include "TDiracMatrix.h"
+#include "TLepton.h"
+#include "TPhoton.h"
+
+const size_t Pickle_header_size = 8;
+
+#if defined DIRACXX_DOUBLE_DOUBLE
+const char Pickle_native = 'w';
+#elif defined DIRACXX_FLOAT128
+const char Pickle_native = 'q';
+#elif defined DIRACXX_DOUBLE
+const char Pickle_native = 'd';
+#else
+const char Pickle_native = 'g';
+#endif
+
+// Pickle_native_bytes is the number of significant bytes at the start
+// of an LDouble_t, the rest being padding.
+
+#if !defined DIRACXX_DOUBLE_DOUBLE && !defined DIRACXX_FLOAT128 && \
+    !defined DIRACXX_DOUBLE && (defined __x86_64__ || defined __i386__) && \
+    LDBL_MANT_DIG == 64
+const size_t Pickle_native_bytes = 10;
+#else
+const size_t Pickle_native_bytes = sizeof(LDouble_t);
+#endif
+
+// Pickle_traits<T> gives the class code and number of real components
+// of T, and copies them out of (Get) and into (Set) an object.
+
+template <class T>
+struct Pickle_traits;
+
+template <>
+struct Pickle_traits<TThreeVectorReal> {
+   enum { code = 'v', ncomp = 3 };
+   static void Get(const TThreeVectorReal &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 3; i++)
+         c[i] = obj[i+1];
+   }
+   static void Set(TThreeVectorReal &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 3; i++)
+         obj[i+1] = c[i];
+   }
+};
+
+template <>
+struct Pickle_traits<TThreeVectorComplex> {
+   enum { code = 'V', ncomp = 6 };
+   static void Get(const TThreeVectorComplex &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 3; i++) {
+         c[2*i] = obj[i+1].real();
+         c[2*i+1] = obj[i+1].imag();
+      }
+   }
+   static void Set(TThreeVectorComplex &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 3; i++)
+         obj[i+1] = Complex_t(c[2*i], c[2*i+1]);
+   }
+};
+
+template <>
+struct Pickle_traits<TFourVectorReal> {
+   enum { code = 'f', ncomp = 4 };
+   static void Get(const TFourVectorReal &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++)
+         c[i] = obj[i];
+   }
+   static void Set(TFourVectorReal &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++)
+         obj[i] = c[i];
+   }
+};
+
+template <>
+struct Pickle_traits<TFourVectorComplex> {
+   enum { code = 'F', ncomp = 8 };
+   static void Get(const TFourVectorComplex &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++) {
+         c[2*i] = obj[i].real();
+         c[2*i+1] = obj[i].imag();
+      }
+   }
+   static void Set(TFourVectorComplex &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++)
+         obj[i] = Complex_t(c[2*i], c[2*i+1]);
+   }
+};
+
+template <>
+struct Pickle_traits<TPauliSpinor> {
+   enum { code = 's', ncomp = 4 };
+   static void Get(const TPauliSpinor &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 2; i++) {
+         c[2*i] = obj[i].real();
+         c[2*i+1] = obj[i].imag();
+      }
+   }
+   static void Set(TPauliSpinor &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 2; i++)
+         obj[i] = Complex_t(c[2*i], c[2*i+1]);
+   }
+};
+
+template <>
+struct Pickle_traits<TDiracSpinor> {
+   enum { code = 'S', ncomp = 8 };
+   static void Get(const TDiracSpinor &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++) {
+         c[2*i] = obj[i].real();
+         c[2*i+1] = obj[i].imag();
+      }
+   }
+   static void Set(TDiracSpinor &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++)
+         obj[i] = Complex_t(c[2*i], c[2*i+1]);
+   }
+};
+
+template <>
+struct Pickle_traits<TPauliMatrix> {
+   enum { code = 'm', ncomp = 8 };
+   static void Get(const TPauliMatrix &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++) {
+         c[2*i] = obj[i/2][i%2].real();
+         c[2*i+1] = obj[i/2][i%2].imag();
+      }
+   }
+   static void Set(TPauliMatrix &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 4; i++)
+         obj[i/2][i%2] = Complex_t(c[2*i], c[2*i+1]);
+   }
+};
+
+template <>
+struct Pickle_traits<TDiracMatrix> {
+   enum { code = 'M', ncomp = 32 };
+   static void Get(const TDiracMatrix &obj, LDouble_t *c) {
+      for (Int_t i=0; i < 16; i++) {
+         c[2*i] = obj[i/4][i%4].real();
+         c[2*i+1] = obj[i/4][i%4].imag();
+      }
+   }
+   static void Set(TDiracMatrix &obj, const LDouble_t *c) {
+      for (Int_t i=0; i < 16; i++)
+         obj[i/4][i%4] = Complex_t(c[2*i], c[2*i+1]);
+   }
+};
+
+template <>
+struct Pickle_traits<TLepton> {
+   enum { code = 'l', ncomp = 13 };
+   static void Get(const TLepton &obj, LDouble_t *c) {
+      c[0] = obj.Mass();
+      Pickle_traits<TFourVectorReal>::Get(obj.Mom(), c + 1);
+      Pickle_traits<TPauliMatrix>::Get(obj.SDM(), c + 5);
+   }
+   static void Set(TLepton &obj, const LDouble_t *c) {
+      TFourVectorReal mom;
+      Pickle_traits<TFourVectorReal>::Set(mom, c + 1);
+      obj.SetMass(c[0]);
+      obj.SetMom(mom);
+      Pickle_traits<TPauliMatrix>::Set(obj.SDM(), c + 5);
+   }
+};
+
+template <>
+struct Pickle_traits<TPhoton> {
+   enum { code = 'p', ncomp = 12 };
+   static void Get(const TPhoton &obj, LDouble_t *c) {
+      Pickle_traits<TFourVectorReal>::Get(obj.Mom(), c);
+      Pickle_traits<TPauliMatrix>::Get(obj.SDM(), c + 4);
+   }
+   static void Set(TPhoton &obj, const LDouble_t *c) {
+      TFourVectorReal mom;
+      Pickle_traits<TFourVectorReal>::Set(mom, c);
+      obj.SetMom(mom);
+      Pickle_traits<TPauliMatrix>::Set(obj.SDM(), c + 4);
+   }
+};
+
+template <class T>
+size_t Pickle_size(UInt_t n, Bool_t dbl=false)
+{
+   // Returns the size in bytes of the image of n objects of class T.
+
+   size_t size = (dbl)? sizeof(Double_t) : sizeof(LDouble_t);
+   return Pickle_header_size + n * Pickle_traits<T>::ncomp * size;
+}
+
+template <class T>
+char *Pickle_header(char *buf, UInt_t n, Bool_t dbl=false)
+{
+   // Writes the header of an image of n objects of class T at buf, and
+   // returns the position of the first object.
+
+   buf[0] = 'D';
+   buf[1] = Pickle_traits<T>::code;
+   buf[2] = (dbl)? 'd' : Pickle_native;
+   buf[3] = (dbl)? sizeof(Double_t) : sizeof(LDouble_t);
+   memcpy(buf + 4, &n, sizeof(UInt_t));
+   return buf + Pickle_header_size;
+}
+
+template <class T>
+char *Pickle_write(char *buf, const T &obj, Bool_t dbl=false)
+{
+   // Writes the components of obj at buf, and returns the position
+   // following them.
+
+   LDouble_t c[Pickle_traits<T>::ncomp];
+   Pickle_traits<T>::Get(obj, c);
+   for (Int_t i=0; i < Pickle_traits<T>::ncomp; i++) {
+      if (dbl) {
+         Double_t value = (Double_t)c[i];
+         memcpy(buf, &value, sizeof(Double_t));
+         buf += sizeof(Double_t);
+      }
+      else {
+         memcpy(buf, &c[i], Pickle_native_bytes);
+         memset(buf + Pickle_native_bytes, 0,
+                sizeof(LDouble_t) - Pickle_native_bytes);
+         buf += sizeof(LDouble_t);
+      }
+   }
+   return buf;
+}
+
+template <class T>
+Int_t Pickle_check(const char *buf, size_t size, UInt_t &n, Bool_t &dbl)
+{
+   // Checks that buf holds a complete image of objects of class T that
+   // can be read by this build, and returns 0 with the number of
+   // objects in n and the format in dbl, or else a nonzero code: 1 if
+   // it is not an image of class T, 2 if its components were written
+   // by a build with another LDouble_t, 3 if it is truncated.
+
+   if (size < Pickle_header_size || buf[0] != 'D' ||
+       buf[1] != (char)Pickle_traits<T>::code)
+   {
+      return 1;
+   }
+   if (buf[2] == 'd' && buf[3] == sizeof(Double_t))
+      dbl = true;
+   else if (buf[2] == Pickle_native && buf[3] == sizeof(LDouble_t))
+      dbl = false;
+   else
+      return 2;
+   memcpy(&n, buf + 4, sizeof(UInt_t));
+   if (size < Pickle_size<T>(n, dbl))
+      return 3;
+   return 0;
+}
+
+template <class T>
+const char *Pickle_read(const char *buf, T &obj, Bool_t dbl=false)
+{
+   // Sets obj from the components at buf, and returns the position
+   // following them.
+
+   LDouble_t c[Pickle_traits<T>::ncomp];
+   for (Int_t i=0; i < Pickle_traits<T>::ncomp; i++) {
+      if (dbl) {
+         Double_t value;
+         memcpy(&value, buf, sizeof(Double_t));
+         c[i] = value;
+         buf += sizeof(Double_t);
+      }
+      else {
+         memcpy(&c[i], buf, sizeof(LDouble_t));
+         buf += sizeof(LDouble_t);
+      }
+   }
+   Pickle_traits<T>::Set(obj, c);
+   return buf;
+}
+
+#endif
@@ -0,0 +1,223 @@
+//
+// Pool.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// A persistent pool of worker threads, shared by the batch evaluations
+// of Batch.h and the producers of Stream.h, so that a python loop that
+// calls the *Array methods many times on small arrays does not pay for
+// starting and joining a new set of threads on every call, and so that
+// the batches and the streams running at the same time share the cores
+// instead of oversubscribing them.
+//
+// The pool is created on first use by Pool_shared, with one worker per
+// hardware thread, and lives until the program exits, when the tasks
+// still in the queue are dropped.  Work is given to it as Pool_task_t
+// objects, which are owned by the caller and queued without copying, so
+// that submitting a task does not allocate.  A task can be submitted
+// for up to n workers at once, which all call its Execute, and Wait
+// removes a task from the queue if it has not been started by all of
+// them, and returns when no worker is still in it, after which the
+// caller may destroy it.
+//
+// Pool_run calls a function for each index 0..n-1 on the pool, with the
+// calling thread taking indices too, so that it makes progress even if
+// all of the workers are busy, for example with the producers of a
+// stream.  The tasks given to the pool must all finish in a bounded
+// time, and none may wait for another task, so that Wait always returns.
+
+#ifndef DIRACXX_POOL
+#define DIRACXX_POOL
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "Rtypes.h"
+
+class Pool_task_t {
+
+   // A unit of work for Pool_t.  The pool links the queued tasks through
+   // fNext, and counts the workers still to start (fSlots) and still in
+   // Execute (fRunning) under its lock.
+
+public:
+   Pool_task_t() : fNext(0), fSlots(0), fRunning(0) { }
+   virtual ~Pool_task_t() { }
+
+   virtual void Execute() = 0;
+
+private:
+   friend class Pool_t;
+
+   Pool_task_t(const Pool_task_t &src);
+   Pool_task_t &operator=(const Pool_task_t &src);
+
+   Pool_task_t *fNext;
+   Int_t fSlots;
+   Int_t fRunning;
+};
+
+class Pool_t {
+
+public:
+   Pool_t(Int_t nthreads)
+    : fHead(0), fTail(0), fStopped(false)
+   {
+      if (nthreads < 1)
+         nthreads = 1;
+      for (Int_t i=0; i < nthreads; i++)
+         fThreads.push_back(std::thread(&Pool_t::Work, this));
+   }
+
+   ~Pool_t()
+   {
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         fStopped = true;
+      }
+      fQueued.notify_all();
+      for (UInt_t i=0; i < fThreads.size(); i++)
+         fThreads[i].join();
+   }
+
+   Int_t Size() const { return fThreads.size(); }
+
+   void Submit(Pool_task_t *task, Int_t nworkers=1)
+   {
+      // Queues task to be executed by nworkers workers.  The task must
+      // not already be queued.
+
+      if (nworkers < 1)
+         return;
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         task->fSlots = nworkers;
+         task->fNext = 0;
+         if (fTail)
+            fTail->fNext = task;
+         else
+            fHead = task;
+         fTail = task;
+      }
+      if (nworkers > 1)
+         fQueued.notify_all();
+      else
+         fQueued.notify_one();
+   }
+
+   void Wait(Pool_task_t *task)
+   {
+      // Withdraws task from the queue, if it is still there, and waits
+      // for the workers that have started it to return from Execute.
+
+      std::unique_lock<std::mutex> lock(fLock);
+      if (task->fSlots > 0) {
+         Pool_task_t *prev = 0;
+         for (Pool_task_t *t=fHead; t; prev=t, t=t->fNext) {
+            if (t == task) {
+               Unlink(prev, t);
+               break;
+            }
+         }
+         task->fSlots = 0;
+      }
+      fDone.wait(lock, [task]{ return task->fRunning == 0; });
+   }
+
+private:
+   Pool_t(const Pool_t &src);
+   Pool_t &operator=(const Pool_t &src);
+
+   void Unlink(Pool_task_t *prev, Pool_task_t *task)
+   {
+      if (prev)
+         prev->fNext = task->fNext;
+      else
+         fHead = task->fNext;
+      if (fTail == task)
+         fTail = prev;
+      task->fNext = 0;
+   }
+
+   void Work()
+   {
+      std::unique_lock<std::mutex> lock(fLock);
+      while (true) {
+         fQueued.wait(lock, [this]{ return fHead != 0 || fStopped; });
+         if (fStopped)
+            break;
+         Pool_task_t *task = fHead;
+         if (--task->fSlots == 0)
+            Unlink(0, task);
+         ++task->fRunning;
+         lock.unlock();
+         task->Execute();
+         lock.lock();
+         if (--task->fRunning == 0)
+            fDone.notify_all();
+      }
+   }
+
+   Pool_task_t *fHead;                   // queued tasks, oldest first
+   Pool_task_t *fTail;
+   Bool_t fStopped;                      // set by the destructor
+   std::mutex fLock;                     // guards all of the above
+   std::condition_variable fQueued;      // signals the workers
+   std::condition_variable fDone;        // signals Wait
+   std::vector<std::thread> fThreads;
+};
+
+inline Pool_t &Pool_shared()
+{
+   // Returns the pool shared by all of the batches and streams.
+
+   static Pool_t pool(std::thread::hardware_concurrency());
+   return pool;
+}
+
+template <class Func>
+class Pool_range_t : public Pool_task_t {
+
+   // Calls func(i) for each i in 0..n-1 not yet taken by another thread.
+
+public:
+   Pool_range_t(Long64_t n, const Func &func)
+    : fCount(n), fIndex(0), fFunc(func) { }
+
+   void Execute()
+   {
+      Long64_t i;
+      while ((i = fIndex.fetch_add(1, std::memory_order_relaxed)) < fCount)
+         fFunc(i);
+   }
+
+private:
+   Long64_t fCount;
+   std::atomic<Long64_t> fIndex;
+   const Func &fFunc;
+};
+
+template <class Func>
+inline void Pool_run(Long64_t n, const Func &func)
+{
+   // Calls func(i) for i = 0..n-1, in parallel on the shared pool and
+   // the calling thread, and returns when all of the calls are done.
+
+   if (n <= 1) {
+      if (n == 1)
+         func(0);
+      return;
+   }
+   Pool_t &pool = Pool_shared();
+   Pool_range_t<Func> task(n, func);
+   pool.Submit(&task, (n - 1 < pool.Size())? n - 1 : pool.Size());
+   task.Execute();
+   pool.Wait(&task);
+}
+
+#endif
@@ -0,0 +1,380 @@
+//
+// Preview.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Single-precision preview of the functions drawn by the demo* macros.
+// A plot only needs 3-4 significant digits, but every point drawn by a
+// TF1 costs a full evaluation of the amplitudes in long double.  The
+// amplitudes themselves cannot be evaluated in float precision, because
+// the gauge cancellations at small recoil momentum amplify the rounding
+// errors by up to 1e12, so instead the preview samples the reference
+// function at a set of nodes, refined where it varies most rapidly,
+// until a cubic through the nodes reproduces the reference function to
+// within the requested fraction of the full scale of the plot.  The
+// cubic is stored in float precision, so that redrawing the function,
+// zooming into it, or scanning it at many points costs no further
+// evaluations of the amplitudes.  Narrow intervals where the cubic does
+// not converge, as at the edges of the physical region, where the
+// function drops to zero, are passed back to the reference function.
+//
+// Preview_t::Eval evaluates the cubic for any number of points at once
+// in a loop that the compiler vectorizes 8-16 wide on hosts with AVX2
+// or AVX-512.  A TF1 calls its function one point at a time, though, so
+// drawing the preview only saves the evaluations of the amplitudes, and
+// the vector loop pays off for callers that pass many points to Eval,
+// as Validate does.
+//
+// The TF1 returned by Preview owns its Preview_t, through the functor
+// it is built on, so the table is freed with the TF1 and shared by any
+// copies of it.  It starts with the parameters of the reference
+// function, and if they are changed the table is rebuilt from the
+// reference function with the new values on the next evaluation.
+//
+// The preview is selected for a single demo* call by its preview
+// argument, or for all of them by SetPreviewMode(true), which sets the
+// default for that argument.  Preview_t::Validate compares the preview
+// with the reference function at the points drawn by the TF1.
+
+#ifndef DIRACXX_PREVIEW
+#define DIRACXX_PREVIEW
+
+#include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <memory>
+#include <cmath>
+
+#include "Double.h"
+
+#include <TF1.h>
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(__CLING__)
+#define PREVIEW_SIMD __attribute__((target_clones("avx512f","avx2","default")))
+#else
+#define PREVIEW_SIMD
+#endif
+
+inline Bool_t &Preview_mode()
+{
+   // Default value of the preview argument of the demo* functions.
+
+   static Bool_t mode = false;
+   return mode;
+}
+
+inline void SetPreviewMode(Bool_t on)
+{
+   Preview_mode() = on;
+}
+
+class Preview_t {
+ public:
+   Preview_t(TF1 *reference, Double_t tolerance=1e-3);
+
+   Int_t GetNodes() const { return fNodes; }
+   Double_t GetExactFraction() const;
+   TF1 *GetReference() const { return fReference; }
+
+   Double_t Evaluate(Double_t *var, Double_t *par);
+   void Eval(const Float_t *x, Float_t *y, Int_t n) const;
+   Double_t Validate(Int_t npoints=0) const;
+
+   enum {
+      kStartIntervals = 8,        // intervals in the first pass
+      kCells = 1024               // narrowest interval is 1 cell wide
+   };
+
+ private:
+   Preview_t(const Preview_t &src);
+   Preview_t &operator=(const Preview_t &src);
+
+   void Build();
+   Double_t Slope(const std::map<Int_t, Double_t> &node, Int_t i) const;
+
+   TF1 *fReference;                // function being previewed
+   Double_t fTolerance;            // requested accuracy of the cubic
+   std::vector<Double_t> fPar;     // parameters the table was built for
+   Int_t fNodes;                   // number of reference evaluations
+   Int_t fExactIntervals;          // number of intervals in fExact
+   Float_t fXmin;                  // lower end of the range
+   Float_t fCellsPerUnit;          // kCells / length of the range
+   std::vector<Int_t> fCell;       // interval containing each cell
+   std::vector<Float_t> fX0;       // lower end of each interval
+   std::vector<Float_t> fInvWidth; // 1 / width of each interval
+   std::vector<Float_t> fA;        // cubic coefficients on each interval,
+   std::vector<Float_t> fB;        // in powers of the fractional position
+   std::vector<Float_t> fC;        // t of x within the interval
+   std::vector<Float_t> fD;
+   std::vector<Int_t> fExact;      // intervals left to the reference
+};
+
+inline Preview_t::Preview_t(TF1 *reference, Double_t tolerance)
+ : fReference(reference),
+   fTolerance(tolerance),
+   fPar(reference->GetParameters(),
+        reference->GetParameters() + reference->GetNpar()),
+   fXmin(reference->GetXmin()),
+   fCellsPerUnit(kCells / (reference->GetXmax() - reference->GetXmin()))
+{
+   Build();
+}
+
+inline void Preview_t::Build()
+{
+   // Samples the reference function at kStartIntervals+1 equally spaced
+   // nodes, then tests each interval between them by evaluating the
+   // reference function at its midpoint.  Intervals where the cubic
+   // through the existing nodes misses the midpoint by more than the
+   // tolerance, as a fraction of the largest value seen, are split and
+   // tested again in the next pass, down to a width of one cell.  Any
+   // that still fail at that width, or across which the function drops
+   // to zero, are left to the reference function.  The midpoints become
+   // nodes of the final interpolant whether or not the test passes.
+
+   const Double_t tolerance = fTolerance;
+   const Double_t step = 1 / (Double_t)fCellsPerUnit;
+   std::map<Int_t, Double_t> node;
+   Double_t scale = 0;
+   for (Int_t i=0; i <= kCells; i += kCells / kStartIntervals) {
+      node[i] = fReference->Eval(fXmin + i * step);
+      scale = (fabs(node[i]) > scale)? fabs(node[i]) : scale;
+   }
+   std::vector<Int_t> pending;
+   for (Int_t i=0; i < kCells; i += kCells / kStartIntervals) {
+      pending.push_back(i);
+   }
+   std::vector<Int_t> exact(kCells, 0);
+   Int_t width = kCells / kStartIntervals;
+   while (pending.size() > 0) {
+      std::vector<Double_t> predicted(pending.size());
+      std::vector<Double_t> midpoint(pending.size());
+      for (UInt_t n=0; n < pending.size(); n++) {
+         Int_t lo = pending[n];
+         Int_t hi = lo + width;
+         predicted[n] = (node[lo] + node[hi]) / 2 +
+                        (Slope(node, lo) - Slope(node, hi)) * width / 8;
+         midpoint[n] = fReference->Eval(fXmin + (lo + width/2) * step);
+      }
+      std::vector<Int_t> failed;
+      for (UInt_t n=0; n < pending.size(); n++) {
+         Int_t lo = pending[n];
+         Int_t mid = lo + width/2;
+         node[mid] = midpoint[n];
+         scale = (fabs(midpoint[n]) > scale)? fabs(midpoint[n]) : scale;
+         Bool_t edge = (node[lo] == 0) != (node[lo + width] == 0);
+         if (edge || fabs(predicted[n] - midpoint[n]) > tolerance * scale) {
+            failed.push_back(lo);
+         }
+      }
+      width /= 2;
+      pending.clear();
+      for (UInt_t n=0; n < failed.size(); n++) {
+         if (width > 1) {
+            pending.push_back(failed[n]);
+            pending.push_back(failed[n] + width);
+         }
+         else {
+            exact[failed[n]] = exact[failed[n] + 1] = 1;
+         }
+      }
+   }
+   fNodes = node.size();
+   fExactIntervals = 0;
+
+   // set up the cubic Hermite interpolant through all of the nodes
+   fCell.resize(kCells);
+   fX0.clear();
+   fInvWidth.clear();
+   fA.clear();
+   fB.clear();
+   fC.clear();
+   fD.clear();
+   fExact.clear();
+   std::map<Int_t, Double_t>::iterator iter = node.begin();
+   while (true) {
+      Int_t lo = iter->first;
+      Double_t f0 = iter->second;
+      if (++iter == node.end()) {
+         break;
+      }
+      Int_t hi = iter->first;
+      Double_t f1 = iter->second;
+      Double_t h = hi - lo;
+      Double_t m0 = Slope(node, lo) * h;
+      Double_t m1 = Slope(node, hi) * h;
+      fX0.push_back(fXmin + lo * step);
+      fInvWidth.push_back(1 / (h * step));
+      fA.push_back(f0);
+      fB.push_back(m0);
+      fC.push_back(3*(f1 - f0) - 2*m0 - m1);
+      fD.push_back(2*(f0 - f1) + m0 + m1);
+      fExact.push_back(exact[lo] || (f0 == 0) != (f1 == 0));
+      fExactIntervals += fExact.back();
+      for (Int_t i=lo; i < hi; i++) {
+         fCell[i] = fA.size() - 1;
+      }
+   }
+}
+
+inline Double_t Preview_t::Slope(const std::map<Int_t, Double_t> &node,
+                                 Int_t i) const
+{
+   // Returns the slope at node i, in units of the function per cell,
+   // from the parabola through it and its neighbours (from the line to
+   // its neighbour at the ends of the range).
+
+   std::map<Int_t, Double_t>::const_iterator here = node.find(i);
+   std::map<Int_t, Double_t>::const_iterator left = here;
+   std::map<Int_t, Double_t>::const_iterator right = here;
+   if (here == node.begin()) {
+      ++right;
+      return (right->second - here->second) / (right->first - here->first);
+   }
+   --left;
+   if (++right == node.end()) {
+      return (here->second - left->second) / (here->first - left->first);
+   }
+   Double_t hl = here->first - left->first;
+   Double_t hr = right->first - here->first;
+   return ((here->second - left->second) / hl * hr +
+           (right->second - here->second) / hr * hl) / (hl + hr);
+}
+
+inline Double_t Preview_t::GetExactFraction() const
+{
+   // Returns the fraction of the range that is left to the reference
+   // function.
+
+   Int_t cells = 0;
+   for (Int_t i=0; i < kCells; i++) {
+      cells += fExact[fCell[i]];
+   }
+   return cells / (Double_t)kCells;
+}
+
+PREVIEW_SIMD
+static void Preview_interpolate(const Float_t *x, Float_t *__restrict y,
+                                Int_t n,
+                                Float_t xmin, Float_t cellsPerUnit,
+                                const Int_t *cell, const Float_t *x0,
+                                const Float_t *invWidth, const Float_t *a,
+                                const Float_t *b, const Float_t *c,
+                                const Float_t *d)
+{
+   // Evaluates the piecewise cubic at the n points x.  The range is
+   // divided into Preview_t::kCells equal cells, and cell[i] is the
+   // index of the interval that contains cell i, where the cubic has
+   // coefficients a,b,c,d in powers of t = (x - x0) * invWidth.  There
+   // are no branches in the loop, and y is declared not to overlap the
+   // tables, so that the loop can be vectorized with gathers.
+
+   for (Int_t k=0; k < n; k++) {
+      Int_t i = (Int_t)((x[k] - xmin) * cellsPerUnit);
+      i = (i < 0)? 0 : i;
+      i = (i < Preview_t::kCells)? i : Preview_t::kCells - 1;
+      Int_t j = cell[i];
+      Float_t t = (x[k] - x0[j]) * invWidth[j];
+      y[k] = ((d[j]*t + c[j])*t + b[j])*t + a[j];
+   }
+}
+
+inline void Preview_t::Eval(const Float_t *x, Float_t *y, Int_t n) const
+{
+   // Evaluates the preview at the n points x, returning the results in y.
+
+   Preview_interpolate(x, y, n, fXmin, fCellsPerUnit, &fCell[0], &fX0[0],
+                       &fInvWidth[0], &fA[0], &fB[0], &fC[0], &fD[0]);
+   if (fExactIntervals == 0) {
+      return;
+   }
+   for (Int_t k=0; k < n; k++) {
+      Int_t i = (Int_t)((x[k] - fXmin) * fCellsPerUnit);
+      if (i >= 0 && i < kCells && fExact[fCell[i]]) {
+         y[k] = fReference->Eval(x[k]);
+      }
+   }
+}
+
+inline Double_t Preview_t::Evaluate(Double_t *var, Double_t *par)
+{
+   // Evaluates the preview at var[0], in the form needed for a TF1.
+   // The parameters are those of the reference function, and if they
+   // differ from the ones the table was built for, they are passed on
+   // to the reference function and the table is built again.
+
+   if (par != 0 && !std::equal(fPar.begin(), fPar.end(), par)) {
+      fPar.assign(par, par + fPar.size());
+      fReference->SetParameters(&fPar[0]);
+      Build();
+   }
+   Float_t x = var[0];
+   Float_t y;
+   Eval(&x, &y, 1);
+   return y;
+}
+
+inline Double_t Preview_t::Validate(Int_t npoints) const
+{
+   // Compares the preview with the reference function at npoints
+   // equally spaced points over the range (by default the points drawn
+   // by the TF1), and returns the largest difference as a fraction of
+   // the largest absolute value of the reference function there.
+
+   if (npoints < 2) {
+      npoints = fReference->GetNpx();
+   }
+   const Double_t xmax = fReference->GetXmax();
+   std::vector<Float_t> x(npoints);
+   std::vector<Float_t> y(npoints);
+   for (Int_t k=0; k < npoints; k++) {
+      x[k] = fXmin + (xmax - fXmin) * k / (npoints - 1);
+   }
+   Eval(&x[0], &y[0], npoints);
+   Double_t scale = 0;
+   Double_t error = 0;
+   for (Int_t k=0; k < npoints; k++) {
+      Double_t ref = fReference->Eval(x[k]);
+      scale = (fabs(ref) > scale)? fabs(ref) : scale;
+      error = (fabs(y[k] - ref) > error)? fabs(y[k] - ref) : error;
+   }
+   return (scale > 0)? error / scale : 0;
+}
+
+struct Preview_functor_t {
+   // The function object of the TF1 returned by Preview.  The TF1 keeps
+   // a copy of it, and the copies share the Preview_t.
+
+   Preview_functor_t(TF1 *reference, Double_t tolerance)
+    : fPreview(new Preview_t(reference, tolerance)) { }
+
+   Double_t operator()(Double_t *var, Double_t *par) const
+   {
+      return fPreview->Evaluate(var, par);
+   }
+
+   std::shared_ptr<Preview_t> fPreview;
+};
+
+inline TF1 *Preview(TF1 *reference, Double_t tolerance=1e-3)
+{
+   // Returns a TF1 that draws a preview of the reference function over
+   // its range, under the same name and with the same parameters.  The
+   // reference function must outlive it.
+
+   Preview_functor_t functor(reference, tolerance);
+   std::cout << "Preview of " << reference->GetName() << " from "
+             << functor.fPreview->GetNodes() << " nodes, "
+             << 100 * functor.fPreview->GetExactFraction()
+             << "% of the range left to the full calculation" << std::endl;
+   TF1 *preview = new TF1(reference->GetName(), functor,
+                          reference->GetXmin(), reference->GetXmax(),
+                          reference->GetNpar());
+   preview->SetParameters(reference->GetParameters());
+   return preview;
+}
+
+#endif
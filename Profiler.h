@@ -0,0 +1,397 @@
+//
+// Profiler.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Scoped timers for the hot paths of the package, so that production
+// runs can report how the time is split between the kinematics, the
+// spinors, the propagators, the products of Dirac matrices and the spin
+// sums inside each cross section, without attaching a profiler.
+//
+// A function is instrumented by declaring DIRACXX_PROFILE_SCOPE("name")
+// at its top, and split into consecutive sections by the statements
+// DIRACXX_PROFILE_SECTION("name") that follow it in the same block.
+// Each section ends where the next one begins, or at the end of the
+// scope.  Scopes entered while a section is active are counted as its
+// children, so the times are aggregated into a tree of call paths, kept
+// separately by each thread, and merged by path when they are reported.
+// The tree of a thread that exits is taken over by the next thread to
+// start, so the number of trees is the most threads ever run at once.
+// The timers read the cpu time stamp counter on x86 hosts, and the
+// steady clock elsewhere.
+//
+// The timers are compiled in only when DIRACXX_PROFILE is defined, and
+// otherwise the macros expand to nothing.  When compiled in, they cost
+// one relaxed atomic load per scope until they are switched on at run
+// time by Profiler_enable(true), or TCrossSection::SetProfiling, after
+// which the report is printed on demand by Profiler_print, and at exit
+// if requested.
+
+#ifndef DIRACXX_PROFILER
+#define DIRACXX_PROFILER
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <stdlib.h>
+
+#include "Double.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+inline ULong64_t Profiler_ticks()
+{
+#if defined(__i386__) || defined(__x86_64__)
+   return __rdtsc();
+#else
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct Profiler_site_t {
+
+   // One instrumentation point, identified by its name.
+
+   const char *name;
+   explicit Profiler_site_t(const char *n) : name(n) { }
+};
+
+struct Profiler_node_t {
+
+   // One call path in the tree of a thread.  The counts are only written
+   // by the owning thread, but can be read at any time by the report.
+   // New children are added under the registry lock.
+
+   const Profiler_site_t *site;
+   std::vector<Profiler_node_t*> children;
+   std::atomic<ULong64_t> calls;
+   std::atomic<ULong64_t> ticks;
+
+   explicit Profiler_node_t(const Profiler_site_t *s)
+    : site(s), calls(0), ticks(0) { }
+};
+
+struct Profiler_registry_t {
+   std::atomic<Bool_t> enabled;
+   std::mutex lock;
+   std::vector<Profiler_node_t*> roots;   // one per thread
+   std::vector<Profiler_node_t*> idle;    // roots of exited threads
+   Bool_t atexit;
+
+   Profiler_registry_t() : enabled(false), atexit(false) { }
+};
+
+inline Profiler_registry_t &Profiler_registry()
+{
+   static Profiler_registry_t registry;
+   return registry;
+}
+
+struct Profiler_owner_t {
+
+   // Holds the root of the tree of a thread, and hands it on to the next
+   // thread that starts profiling when this one exits, so that the
+   // generators that start new threads for each pass only need as many
+   // trees as they run threads at once.  The counts of the successive
+   // threads that used a tree are summed in it, as they would be by the
+   // report anyway.
+
+   Profiler_node_t *root;
+   Profiler_node_t *current;              // innermost active node
+
+   Profiler_owner_t() : root(0), current(0) { }
+   ~Profiler_owner_t()
+   {
+      if (root) {
+         Profiler_registry_t &reg = Profiler_registry();
+         std::lock_guard<std::mutex> guard(reg.lock);
+         reg.idle.push_back(root);
+      }
+   }
+};
+
+inline Profiler_node_t *&Profiler_current()
+{
+   // Returns the innermost active node of the calling thread, taking an
+   // idle tree or creating and registering a new one the first time.
+
+   static thread_local Profiler_owner_t owner;
+   if (owner.current == 0) {
+      static Profiler_site_t rootSite("thread");
+      Profiler_registry_t &reg = Profiler_registry();
+      std::lock_guard<std::mutex> guard(reg.lock);
+      if (reg.idle.size() > 0) {
+         owner.root = reg.idle.back();
+         reg.idle.pop_back();
+      }
+      else {
+         owner.root = new Profiler_node_t(&rootSite);
+         reg.roots.push_back(owner.root);
+      }
+      owner.current = owner.root;
+   }
+   return owner.current;
+}
+
+inline Profiler_node_t *Profiler_child(Profiler_node_t *node,
+                                       const Profiler_site_t &site)
+{
+   // Returns the child of node for the given site, adding it if this
+   // path has not been seen before.
+
+   for (UInt_t i=0; i < node->children.size(); i++) {
+      if (node->children[i]->site == &site)
+         return node->children[i];
+   }
+   Profiler_node_t *child = new Profiler_node_t(&site);
+   std::lock_guard<std::mutex> guard(Profiler_registry().lock);
+   node->children.push_back(child);
+   return child;
+}
+
+inline void Profiler_count(Profiler_node_t *node, ULong64_t ticks)
+{
+   node->calls.store(node->calls.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+   node->ticks.store(node->ticks.load(std::memory_order_relaxed) + ticks,
+                     std::memory_order_relaxed);
+}
+
+class Profiler_scope_t {
+
+   // Times the enclosing block as a child of the innermost active node
+   // of the calling thread, and each of its sections as children of it.
+
+public:
+   explicit Profiler_scope_t(const Profiler_site_t &site)
+    : fNode(0), fSection(0)
+   {
+      if (!Profiler_registry().enabled.load(std::memory_order_relaxed))
+         return;
+      Profiler_node_t *&current = Profiler_current();
+      fParent = current;
+      fNode = Profiler_child(fParent, site);
+      current = fNode;
+      fStart = Profiler_ticks();
+   }
+
+   ~Profiler_scope_t()
+   {
+      if (fNode == 0)
+         return;
+      ULong64_t now = Profiler_ticks();
+      EndSection(now);
+      Profiler_count(fNode, now - fStart);
+      Profiler_current() = fParent;
+   }
+
+   void Section(const Profiler_site_t &site)
+   {
+      if (fNode == 0)
+         return;
+      ULong64_t now = Profiler_ticks();
+      EndSection(now);
+      fSection = Profiler_child(fNode, site);
+      fSectionStart = now;
+      Profiler_current() = fSection;
+   }
+
+private:
+   void EndSection(ULong64_t now)
+   {
+      if (fSection) {
+         Profiler_count(fSection, now - fSectionStart);
+         fSection = 0;
+         Profiler_current() = fNode;
+      }
+   }
+
+   Profiler_node_t *fParent;
+   Profiler_node_t *fNode;
+   Profiler_node_t *fSection;
+   ULong64_t fStart;
+   ULong64_t fSectionStart;
+};
+
+#if defined DIRACXX_PROFILE
+#define DIRACXX_PROFILE_CONCAT2(a, b) a ## b
+#define DIRACXX_PROFILE_CONCAT(a, b) DIRACXX_PROFILE_CONCAT2(a, b)
+#define DIRACXX_PROFILE_SCOPE(name)                                        \
+   static const Profiler_site_t                                            \
+      DIRACXX_PROFILE_CONCAT(profilerSite, __LINE__)(name);                \
+   Profiler_scope_t profilerScope(                                         \
+      DIRACXX_PROFILE_CONCAT(profilerSite, __LINE__))
+#define DIRACXX_PROFILE_SECTION(name)                                      \
+   static const Profiler_site_t                                            \
+      DIRACXX_PROFILE_CONCAT(profilerSite, __LINE__)(name);                \
+   profilerScope.Section(DIRACXX_PROFILE_CONCAT(profilerSite, __LINE__))
+#else
+#define DIRACXX_PROFILE_SCOPE(name)
+#define DIRACXX_PROFILE_SECTION(name)
+#endif
+
+//----- report -----------------------------------------------------------------
+
+struct Profiler_summary_t {
+   std::string name;
+   ULong64_t calls;
+   ULong64_t ticks;
+   std::vector<Profiler_summary_t> children;
+};
+
+inline void Profiler_merge(Profiler_summary_t &sum, const Profiler_node_t *node)
+{
+   // Adds the counts in the tree below node into the summary, matching
+   // the children by name, in order of first appearance.
+
+   sum.calls += node->calls.load(std::memory_order_relaxed);
+   sum.ticks += node->ticks.load(std::memory_order_relaxed);
+   for (UInt_t i=0; i < node->children.size(); i++) {
+      const Profiler_node_t *child = node->children[i];
+      UInt_t j = 0;
+      while (j < sum.children.size() &&
+             sum.children[j].name != child->site->name)
+      {
+         ++j;
+      }
+      if (j == sum.children.size()) {
+         Profiler_summary_t empty = {child->site->name, 0, 0, {}};
+         sum.children.push_back(empty);
+      }
+      Profiler_merge(sum.children[j], child);
+   }
+}
+
+inline Double_t Profiler_ns_per_tick()
+{
+   // Returns the length of one tick in ns, measuring the rate of the time
+   // stamp counter against the steady clock over 20 ms the first time.
+
+#if defined(__i386__) || defined(__x86_64__)
+   static Double_t nsPerTick = 0;
+   if (nsPerTick == 0) {
+      typedef std::chrono::steady_clock clock;
+      auto start = clock::now();
+      ULong64_t ticks0 = Profiler_ticks();
+      while (clock::now() - start < std::chrono::milliseconds(20)) { }
+      ULong64_t ticks1 = Profiler_ticks();
+      std::chrono::duration<Double_t, std::nano> dt = clock::now() - start;
+      nsPerTick = dt.count() / (ticks1 - ticks0);
+   }
+   return nsPerTick;
+#else
+   return 1;
+#endif
+}
+
+inline void Profiler_print_node(std::ostream &out,
+                                const Profiler_summary_t &node,
+                                ULong64_t parentTicks, Int_t depth,
+                                Double_t nsPerTick)
+{
+   std::string label = std::string(2 * depth, ' ') + node.name;
+   out << std::left << std::setw(56) << label << std::right
+       << std::setw(12) << node.calls
+       << std::fixed << std::setprecision(3)
+       << std::setw(14) << node.ticks * nsPerTick * 1e-6
+       << std::setprecision(1)
+       << std::setw(9) << 100. * node.ticks / parentTicks
+       << std::setprecision(0)
+       << std::setw(14) << ((node.calls > 0)?
+                            node.ticks * nsPerTick / node.calls : 0)
+       << std::endl;
+   ULong64_t childTicks = 0;
+   for (UInt_t i=0; i < node.children.size(); i++) {
+      Profiler_print_node(out, node.children[i], node.ticks, depth + 1,
+                          nsPerTick);
+      childTicks += node.children[i].ticks;
+   }
+   if (node.children.size() > 0 && node.ticks > childTicks) {
+      Profiler_summary_t self = {"(self)", 0, node.ticks - childTicks, {}};
+      Profiler_print_node(out, self, node.ticks, depth + 1, nsPerTick);
+   }
+}
+
+inline void Profiler_print(std::ostream &out=std::cout)
+{
+   // Prints the times of all of the instrumented scopes and sections,
+   // merged over all threads, as a tree indented by call path, with the
+   // number of calls, the total time, the percentage of the time of the
+   // parent and the mean time per call.
+
+   Profiler_registry_t &reg = Profiler_registry();
+   Profiler_summary_t total = {"total", 0, 0, {}};
+   Int_t nthreads;
+   {
+      std::lock_guard<std::mutex> guard(reg.lock);
+      for (UInt_t i=0; i < reg.roots.size(); i++)
+         Profiler_merge(total, reg.roots[i]);
+      nthreads = reg.roots.size();
+   }
+   total.calls = 0;
+   total.ticks = 0;
+   for (UInt_t i=0; i < total.children.size(); i++)
+      total.ticks += total.children[i].ticks;
+   if (total.ticks == 0) {
+      out << "Profiler: no instrumented scopes were timed" << std::endl;
+      return;
+   }
+   Double_t nsPerTick = Profiler_ns_per_tick();
+   std::ios::fmtflags flags = out.flags();
+   std::streamsize precision = out.precision();
+   out << "Profile of " << nthreads << " thread(s), times summed"
+       << " over threads" << std::endl
+       << std::left << std::setw(56) << "scope" << std::right
+       << std::setw(12) << "calls" << std::setw(14) << "total ms"
+       << std::setw(9) << "%parent" << std::setw(14) << "ns/call"
+       << std::endl;
+   for (UInt_t i=0; i < total.children.size(); i++)
+      Profiler_print_node(out, total.children[i], total.ticks, 0, nsPerTick);
+   out.flags(flags);
+   out.precision(precision);
+}
+
+inline void Profiler_reset()
+{
+   // Zeroes the counts of all threads, keeping the call paths.
+
+   Profiler_registry_t &reg = Profiler_registry();
+   std::lock_guard<std::mutex> guard(reg.lock);
+   std::vector<Profiler_node_t*> stack(reg.roots);
+   while (stack.size() > 0) {
+      Profiler_node_t *node = stack.back();
+      stack.pop_back();
+      node->calls.store(0, std::memory_order_relaxed);
+      node->ticks.store(0, std::memory_order_relaxed);
+      stack.insert(stack.end(), node->children.begin(), node->children.end());
+   }
+}
+
+inline void Profiler_print_atexit()
+{
+   Profiler_print(std::cout);
+}
+
+inline void Profiler_enable(Bool_t on, Bool_t printAtExit=true)
+{
+   // Switches the timers on or off for all threads.  If printAtExit is
+   // set, the report is also printed to stdout when the program exits.
+
+   Profiler_registry_t &reg = Profiler_registry();
+   reg.enabled.store(on);
+   if (on && printAtExit && !reg.atexit) {
+      reg.atexit = true;
+      atexit(Profiler_print_atexit);
+   }
+}
+
+#endif
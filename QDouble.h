@@ -0,0 +1,208 @@
+//
+// QDouble.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Defines the quad-precision scalar type QDouble_t, a thin wrapper
+// around the gcc __float128 type (113 bits of mantissa) with the
+// arithmetic done in software by libquadmath.  It is far too slow for
+// production, but it serves as the reference against which the results
+// of the faster scalar types are validated, see precision.cxx.  The type
+// can be substituted for LDouble_t throughout the package by building
+// with the preprocessor symbol DIRACXX_FLOAT128 defined and linking with
+// -lquadmath, see Double.h.
+//
+// The wrapper class is needed rather than a plain typedef of __float128
+// so that the overloads of the elementary functions below are found by
+// argument-dependent lookup from inside std::complex, where the ones in
+// <cmath> for the built-in floating types would otherwise be ambiguous.
+
+#ifndef DIRACXX_QDOUBLE
+#define DIRACXX_QDOUBLE
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include <quadmath.h>
+
+class QDouble_t {
+
+public:
+   QDouble_t() : q(0) { }
+   QDouble_t(const double x) : q(x) { }
+   QDouble_t(const float x) : q(x) { }
+   QDouble_t(const int x) : q(x) { }
+   QDouble_t(const unsigned int x) : q(x) { }
+   QDouble_t(const long double x) : q(x) { }
+   QDouble_t(const long x) : q(x) { }
+   QDouble_t(const unsigned long x) : q(x) { }
+   QDouble_t(const long long x) : q(x) { }
+   QDouble_t(const unsigned long long x) : q(x) { }
+   QDouble_t(const __float128 x) : q(x) { }
+
+   // The conversions to the built-in types are explicit, so that a
+   // silent loss of precision cannot creep into the package code.
+   explicit operator double() const { return (double)q; }
+   explicit operator float() const { return (float)q; }
+   explicit operator long double() const { return (long double)q; }
+
+   QDouble_t operator-() const { return QDouble_t(-q); }
+   QDouble_t &operator+=(const QDouble_t &b) { q += b.q; return *this; }
+   QDouble_t &operator-=(const QDouble_t &b) { q -= b.q; return *this; }
+   QDouble_t &operator*=(const QDouble_t &b) { q *= b.q; return *this; }
+   QDouble_t &operator/=(const QDouble_t &b) { q /= b.q; return *this; }
+
+   __float128 q;
+};
+
+//----- arithmetic -------------------------------------------------------------
+
+inline QDouble_t operator+(const QDouble_t &a, const QDouble_t &b)
+{
+   return QDouble_t(a.q + b.q);
+}
+
+inline QDouble_t operator-(const QDouble_t &a, const QDouble_t &b)
+{
+   return QDouble_t(a.q - b.q);
+}
+
+inline QDouble_t operator*(const QDouble_t &a, const QDouble_t &b)
+{
+   return QDouble_t(a.q * b.q);
+}
+
+inline QDouble_t operator/(const QDouble_t &a, const QDouble_t &b)
+{
+   return QDouble_t(a.q / b.q);
+}
+
+inline bool operator==(const QDouble_t &a, const QDouble_t &b)
+{
+   return a.q == b.q;
+}
+
+inline bool operator!=(const QDouble_t &a, const QDouble_t &b)
+{
+   return a.q != b.q;
+}
+
+inline bool operator<(const QDouble_t &a, const QDouble_t &b)
+{
+   return a.q < b.q;
+}
+
+inline bool operator>(const QDouble_t &a, const QDouble_t &b)
+{
+   return a.q > b.q;
+}
+
+inline bool operator<=(const QDouble_t &a, const QDouble_t &b)
+{
+   return a.q <= b.q;
+}
+
+inline bool operator>=(const QDouble_t &a, const QDouble_t &b)
+{
+   return a.q >= b.q;
+}
+
+// Overloads of the operators for a QDouble_t mixed with each of the
+// built-in arithmetic types, as for DDouble_t.
+
+#define QDOUBLE_MIXED_OPERATOR(OP, RESULT, TYPE)                        \
+inline RESULT operator OP(const QDouble_t &a, const TYPE b)             \
+{ return a OP QDouble_t(b); }                                           \
+inline RESULT operator OP(const TYPE a, const QDouble_t &b)             \
+{ return QDouble_t(a) OP b; }
+
+#define QDOUBLE_MIXED_OPERATORS(TYPE)                                   \
+QDOUBLE_MIXED_OPERATOR(+, QDouble_t, TYPE)                              \
+QDOUBLE_MIXED_OPERATOR(-, QDouble_t, TYPE)                              \
+QDOUBLE_MIXED_OPERATOR(*, QDouble_t, TYPE)                              \
+QDOUBLE_MIXED_OPERATOR(/, QDouble_t, TYPE)                              \
+QDOUBLE_MIXED_OPERATOR(==, bool, TYPE)                                  \
+QDOUBLE_MIXED_OPERATOR(!=, bool, TYPE)                                  \
+QDOUBLE_MIXED_OPERATOR(<, bool, TYPE)                                   \
+QDOUBLE_MIXED_OPERATOR(>, bool, TYPE)                                   \
+QDOUBLE_MIXED_OPERATOR(<=, bool, TYPE)                                  \
+QDOUBLE_MIXED_OPERATOR(>=, bool, TYPE)
+
+QDOUBLE_MIXED_OPERATORS(double)
+QDOUBLE_MIXED_OPERATORS(float)
+QDOUBLE_MIXED_OPERATORS(int)
+QDOUBLE_MIXED_OPERATORS(unsigned int)
+QDOUBLE_MIXED_OPERATORS(long)
+QDOUBLE_MIXED_OPERATORS(unsigned long)
+QDOUBLE_MIXED_OPERATORS(long long)
+QDOUBLE_MIXED_OPERATORS(unsigned long long)
+QDOUBLE_MIXED_OPERATORS(long double)
+
+#undef QDOUBLE_MIXED_OPERATORS
+#undef QDOUBLE_MIXED_OPERATOR
+
+//----- elementary functions ---------------------------------------------------
+
+inline QDouble_t fabs(const QDouble_t &a) { return fabsq(a.q); }
+inline QDouble_t abs(const QDouble_t &a) { return fabsq(a.q); }
+inline QDouble_t floor(const QDouble_t &a) { return floorq(a.q); }
+inline QDouble_t ldexp(const QDouble_t &a, const int n) { return ldexpq(a.q, n); }
+inline QDouble_t sqrt(const QDouble_t &a) { return sqrtq(a.q); }
+inline QDouble_t exp(const QDouble_t &a) { return expq(a.q); }
+inline QDouble_t log(const QDouble_t &a) { return logq(a.q); }
+inline QDouble_t sin(const QDouble_t &a) { return sinq(a.q); }
+inline QDouble_t cos(const QDouble_t &a) { return cosq(a.q); }
+inline QDouble_t sinh(const QDouble_t &a) { return sinhq(a.q); }
+inline QDouble_t cosh(const QDouble_t &a) { return coshq(a.q); }
+inline QDouble_t asinh(const QDouble_t &a) { return asinhq(a.q); }
+
+inline QDouble_t atan2(const QDouble_t &y, const QDouble_t &x)
+{
+   return atan2q(y.q, x.q);
+}
+
+inline QDouble_t atan2(const QDouble_t &y, const double x)
+{
+   return atan2q(y.q, x);
+}
+
+inline QDouble_t pow(const QDouble_t &a, const int n)
+{
+   return powq(a.q, n);
+}
+
+inline QDouble_t pow(const QDouble_t &a, const QDouble_t &b)
+{
+   return powq(a.q, b.q);
+}
+
+inline QDouble_t pow(const QDouble_t &a, const double b)
+{
+   return powq(a.q, b);
+}
+
+inline std::ostream &operator<<(std::ostream &out, const QDouble_t &a)
+{
+   // Prints a to the stream precision, up to the 34 significant digits
+   // carried by the type.
+
+   int digits = (out.precision() > 0)? out.precision() : 6;
+   digits = (digits > 34)? 34 : digits;
+   char buf[64];
+   quadmath_snprintf(buf, sizeof(buf), "%.*Qg", digits, a.q);
+   return out << buf;
+}
+
+inline std::istream &operator>>(std::istream &in, QDouble_t &a)
+{
+   std::string word;
+   if (in >> word) {
+      a.q = strtoflt128(word.c_str(), 0);
+   }
+   return in;
+}
+
+#endif
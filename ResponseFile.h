@@ -0,0 +1,95 @@
+//
+// ResponseFile.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Defines the layout of the binary files in which the event generators
+// save the polarization response of each event, as computed by
+// TAmplitudeTensor::PackResponse.  A response file consists of a fixed
+// header followed by one record per generated event, each of the form
+//
+//     Double_t weight;              // inverse sampling density
+//     Double_t response[nvalues];   // packed response tensor
+//
+// such that the weighted cross section of the event for any choice of
+// initial-state spin-density matrices is weight times the contraction
+// of response with those SDMs (see TAmplitudeTensor::ContractPacked).
+// All records have the same size, so that the file can be mapped into
+// memory and processed as an array, see Reweight.C.
+
+#ifndef DIRACXX_RESPONSE_FILE
+#define DIRACXX_RESPONSE_FILE
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Double.h"
+
+struct ResponseFile_header_t {
+   char  magic[8];       // "DIRACRSP"
+   Int_t version;        // layout version, currently 1
+   Int_t nlegs;          // number of initial-state legs in response
+   Int_t nvalues;        // number of packed values per record, 4^nlegs
+   Int_t reserved;       // zero, pads the header to 8-byte boundary
+};
+
+const Int_t ResponseFile_version = 1;
+
+inline FILE *ResponseFile_create(const char *name, const Int_t nlegs)
+{
+   // Opens a new response file for writing and writes its header.
+   // Returns 0 if the file cannot be created.
+
+   FILE *fp = fopen(name, "wb");
+   if (fp == 0)
+      return 0;
+   ResponseFile_header_t header;
+   memcpy(header.magic, "DIRACRSP", 8);
+   header.version = ResponseFile_version;
+   header.nlegs = nlegs;
+   header.nvalues = 1 << (2*nlegs);
+   header.reserved = 0;
+   if (fwrite(&header, sizeof(header), 1, fp) != 1) {
+      fclose(fp);
+      return 0;
+   }
+   return fp;
+}
+
+inline Int_t ResponseFile_legs(const char *name)
+{
+   // Returns the number of initial-state legs in the response saved in
+   // the response file name, or -1 if it has no valid header.
+
+   FILE *fp = fopen(name, "rb");
+   if (fp == 0)
+      return -1;
+   ResponseFile_header_t header;
+   Bool_t ok = (fread(&header, sizeof(header), 1, fp) == 1);
+   fclose(fp);
+   if (!ok || memcmp(header.magic, "DIRACRSP", 8) != 0 ||
+       header.version != ResponseFile_version)
+   {
+      return -1;
+   }
+   return header.nlegs;
+}
+
+inline Int_t ResponseFile_write(FILE *fp, const Double_t weight,
+                                const Double_t *response,
+                                const Int_t nvalues)
+{
+   // Appends one event record to a response file.  Returns 0 on
+   // success, -1 on a write error.
+
+   if (fwrite(&weight, sizeof(Double_t), 1, fp) != 1 ||
+       fwrite(response, sizeof(Double_t), nvalues, fp) != (size_t)nvalues)
+   {
+      return -1;
+   }
+   return 0;
+}
+
+#endif
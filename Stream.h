@@ -0,0 +1,254 @@
+//
+// Stream.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Background generation of events in fixed-size chunks, for consumers
+// such as the python iterators PairsStream and TripletsStream that take
+// the events directly from memory instead of from a tree on disk.
+//
+// A Stream_t has nthreads producers, each with its own TRandom2, that
+// call the fill function of the stream to generate one chunk of events
+// at a time, and push the finished chunks onto a queue holding at most
+// prefetch chunks.  The producers run on the worker pool of Pool.h,
+// shared with the batch evaluations of Batch.h, as a task per chunk, and
+// a producer resubmits itself after each chunk until the queue is full,
+// so that the workers are not held by a stream that is waiting for its
+// consumer.  Next takes the oldest chunk from the queue, and only waits
+// if the queue is empty, that is when the consumer is slower than the
+// producers, and restarts one producer that has stopped on a full
+// queue, so that the memory in use is bounded by (prefetch + nthreads)
+// chunks however slow the consumer.  The stream ends after nchunks
+// chunks have been taken, or never if nchunks < 0, and Stop, which is
+// also called by the destructor, stops the producers early and frees
+// the chunks left in the queue.
+//
+// The consumer gives each chunk back with Recycle when it is done with
+// it, and the producers fill the recycled chunks before allocating new
+// ones, so that once the stream holds as many chunks as are in use at
+// one time, it makes no further calls to malloc however many chunks it
+// generates.  The free list keeps at most (prefetch + nthreads + 1)
+// chunks, as many as are in use with a consumer that holds one chunk at
+// a time, and frees any recycled beyond that, so that memory use stays
+// flat.  The queue is a ring allocated with the stream, with a slot for
+// each chunk that can be queued at once, (prefetch + nthreads) since the
+// producers that started while the queue had room may all finish after
+// it has filled up.
+// A recycled chunk still holds the events it was last filled with, so
+// the fill function must set every field of all n events.
+//
+// The chunks are handed to the consumer in the order they are finished,
+// so with more than one producer the sequence of events depends on the
+// timing of the workers, although the events generated by each producer
+// only depend on its seed.  Producer i is seeded with seed + i, or with
+// 0 if seed is 0, which makes TRandom2 pick a different seed each time.
+
+#ifndef DIRACXX_STREAM
+#define DIRACXX_STREAM
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <TRandom2.h>
+
+#include "Double.h"
+#include "Pool.h"
+
+template <class Event>
+class Stream_t {
+
+public:
+   typedef std::function<Int_t(Event *events, Int_t n, TRandom &random_gen)>
+           Fill_t;
+
+   Stream_t(const Fill_t &fill, Int_t chunk, Long64_t nchunks=-1,
+            Int_t nthreads=1, Int_t prefetch=4, UInt_t seed=0)
+    : fFill(fill), fChunk((chunk > 0)? chunk : 1), fRemaining(nchunks),
+      fPrefetch((prefetch > 0)? prefetch : 1), fFilling(0), fStopped(false),
+      fHead(0), fQueued(0)
+   {
+      if (nthreads < 1)
+         nthreads = 1;
+      fQueue.resize(fPrefetch + nthreads);
+      fFreeMax = fPrefetch + nthreads + 1;
+      fFree.reserve(fFreeMax);
+      for (Int_t i=0; i < nthreads; i++) {
+         UInt_t tseed = (seed)? seed + i : 0;
+         fProducers.push_back(new Producer_t(this, tseed));
+      }
+      std::lock_guard<std::mutex> guard(fLock);
+      for (UInt_t i=0; i < fProducers.size(); i++)
+         Pool_shared().Submit(fProducers[i]);
+   }
+
+   ~Stream_t()
+   {
+      Stop();
+      for (UInt_t i=0; i < fProducers.size(); i++)
+         delete fProducers[i];
+   }
+
+   Event *Next(Long64_t *trials=0)
+   {
+      // Returns the next chunk of Chunk() events, which the caller takes
+      // over and must give back with Recycle, or free with delete[], or
+      // 0 at the end of the stream.  If trials is not null, it receives
+      // the value returned by the fill function for the chunk.
+
+      std::unique_lock<std::mutex> lock(fLock);
+      fNotEmpty.wait(lock, [this]{ return fQueued > 0 || Finished(); });
+      if (fQueued == 0)
+         return 0;
+      Chunk_t next = fQueue[fHead];
+      fHead = (fHead + 1) % fQueue.size();
+      --fQueued;
+      Restart();
+      if (trials)
+         *trials = next.trials;
+      return next.events;
+   }
+
+   void Recycle(Event *events)
+   {
+      // Gives back a chunk returned by Next, to be filled again by the
+      // producers, or frees it if the free list is full or the stream
+      // has been stopped.
+
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         if (!fStopped && (Int_t)fFree.size() < fFreeMax) {
+            fFree.push_back(events);
+            return;
+         }
+      }
+      delete [] events;
+   }
+
+   void Stop()
+   {
+      // Stops the producers, waits for them to finish the chunks they
+      // are working on, and frees all of the chunks not yet taken and
+      // those on the free list.
+
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         fStopped = true;
+      }
+      for (UInt_t i=0; i < fProducers.size(); i++)
+         Pool_shared().Wait(fProducers[i]);
+      std::lock_guard<std::mutex> guard(fLock);
+      for (; fQueued > 0; --fQueued) {
+         delete [] fQueue[fHead].events;
+         fHead = (fHead + 1) % fQueue.size();
+      }
+      for (UInt_t i=0; i < fFree.size(); i++)
+         delete [] fFree[i];
+      fFree.clear();
+      fNotEmpty.notify_all();
+   }
+
+   Int_t Chunk() const { return fChunk; }
+
+private:
+   Stream_t(const Stream_t &src);
+   Stream_t &operator=(const Stream_t &src);
+
+   struct Chunk_t {
+      Event *events;
+      Long64_t trials;
+   };
+
+   struct Producer_t : public Pool_task_t {
+      Stream_t *stream;
+      TRandom2 random_gen;
+      Bool_t idle;                       // waiting for room in the queue
+
+      Producer_t(Stream_t *s, UInt_t seed)
+       : stream(s), random_gen(seed), idle(false) { }
+
+      void Execute() { stream->Produce(*this); }
+   };
+
+   Bool_t Finished() const
+   {
+      return (fStopped || fRemaining == 0) && fFilling == 0;
+   }
+
+   void Restart()
+   {
+      // Resubmits one idle producer, if there is room for its chunk.
+
+      if (fStopped || fRemaining == 0 || fQueued >= fPrefetch)
+         return;
+      for (UInt_t i=0; i < fProducers.size(); i++) {
+         if (fProducers[i]->idle) {
+            fProducers[i]->idle = false;
+            Pool_shared().Submit(fProducers[i]);
+            return;
+         }
+      }
+   }
+
+   void Produce(Producer_t &producer)
+   {
+      // Generates one chunk, in a recycled one if there is any, and then
+      // resubmits the producer if there is room for another, or leaves it
+      // idle.  The resubmission is made with fLock held, so that Stop
+      // cannot miss it.
+
+      Chunk_t chunk;
+      chunk.events = 0;
+      {
+         std::lock_guard<std::mutex> guard(fLock);
+         if (fStopped || fRemaining == 0 || fQueued >= fPrefetch) {
+            producer.idle = true;
+            return;
+         }
+         if (fRemaining > 0)
+            --fRemaining;
+         ++fFilling;
+         if (!fFree.empty()) {
+            chunk.events = fFree.back();
+            fFree.pop_back();
+         }
+      }
+      if (chunk.events == 0)
+         chunk.events = new Event[fChunk];
+      chunk.trials = fFill(chunk.events, fChunk, producer.random_gen);
+      std::lock_guard<std::mutex> guard(fLock);
+      --fFilling;
+      if (fStopped) {
+         delete [] chunk.events;
+      }
+      else {
+         fQueue[(fHead + fQueued) % fQueue.size()] = chunk;
+         ++fQueued;
+         if (fRemaining != 0 && fQueued < fPrefetch)
+            Pool_shared().Submit(&producer);
+         else
+            producer.idle = true;
+      }
+      fNotEmpty.notify_all();
+   }
+
+   Fill_t fFill;                         // generates one chunk of events
+   Int_t fChunk;                         // number of events per chunk
+   Long64_t fRemaining;                  // chunks not yet started, or -1
+   Int_t fPrefetch;                      // chunks queued before pausing
+   Int_t fFilling;                       // chunks being generated
+   Bool_t fStopped;                      // set by Stop
+   std::vector<Chunk_t> fQueue;          // ring of finished chunks
+   Int_t fHead;                          // slot of the oldest chunk
+   Int_t fQueued;                        // finished chunks in the ring
+   std::vector<Event*> fFree;            // recycled chunks
+   Int_t fFreeMax;                       // capacity of fFree
+   std::vector<Producer_t*> fProducers;  // idle flags guarded by fLock
+   std::mutex fLock;                     // guards all of the above
+   std::condition_variable fNotEmpty;    // signals the consumer
+};
+
+#endif
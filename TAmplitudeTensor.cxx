@@ -0,0 +1,407 @@
+//
+// TAmplitudeTensor.cxx
+//
+// author:  Richard T. Jones  10/18/26
+// version:  Oct. 18, 2026  v1.00
+//
+/*************************************************************************
+ * Copyright(c) 1998, University of Connecticut, All rights reserved.    *
+ * Author: Richard T. Jones, Asst. Prof. of Physics                      *
+ *                                                                       *
+ * Permission to use, copy, modify and distribute this software and its  *
+ * documentation for non-commercial purposes is hereby granted without   *
+ * fee, provided that the above copyright notice appears in all copies   *
+ * and that both the copyright notice and this permission notice appear  *
+ * in the supporting documentation. The author makes no claims about the *
+ * suitability of this software for any purpose.                         *
+ * It is provided "as is" without express or implied warranty.           *
+ *************************************************************************/
+//////////////////////////////////////////////////////////////////////////
+//
+// The TAmplitudeTensor class stores the helicity amplitudes M(h0,h1,..)
+// computed by TCrossSection for a single kinematic point, before they
+// are contracted with the spin-density matrices of the external legs.
+// Keeping the amplitudes around means that any number of polarization
+// observables can be formed from a single evaluation of the Feynman
+// graphs, which is by far the most expensive part of the calculation.
+//
+// The contraction follows rule 8 in the header of TCrossSection.cxx:
+//
+//                  ---    ---                     ---
+//    |M|^2    =    >      >    M(h) M*(hbar)  |  |  R_l(h_l,hbar_l)
+//                  ---    ---                    l
+//                   h     hbar
+//
+// where R_l(h,hbar) = SDM_l[h][hbar] for an initial-state leg, and
+// R_l(h,hbar) = SDM_l[hbar][h] for a final-state leg.  Rather than
+// summing over all 4^n terms, the SDM of each leg is applied in turn
+// to the conjugate amplitude vector, which costs only 2n*2^n complex
+// multiplications for n legs.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <vector>
+
+#include "TAmplitudeTensor.h"
+
+ClassImp(TAmplitudeTensor)
+
+// The packed responses used by the generators are for one or two legs,
+// with at most 16 values, so buffers of that size are kept on the stack
+// and only larger ones, up to 4^kMaxLegs, are taken from the heap.
+static const Int_t kStackValues = 16;
+
+
+TAmplitudeTensor &TAmplitudeTensor::SetLegs(const Int_t legs,
+                                            const Int_t finalMask)
+{
+   // Declares the number of polarized external legs and which of them
+   // belong to the final state (bit l of finalMask set for leg l).
+   // The amplitudes are reset to zero.
+
+   if (legs < 0 || legs > kMaxLegs) {
+      Error("TAmplitudeTensor::SetLegs","number of legs out of range");
+      fLegs = 0;
+      fFinalMask = 0;
+      return *this;
+   }
+   fLegs = legs;
+   fFinalMask = finalMask;
+   return Zero();
+}
+
+void TAmplitudeTensor::ApplySDM(Complex_t *w, const Int_t leg,
+                                const TPauliMatrix &sdm) const
+{
+   // Multiplies the tensor w in place by R_l along the index of leg,
+   // with R_l defined as in the class description above.
+
+   Complex_t r[2][2];
+   if (IsFinal(leg)) {
+      r[0][0] = sdm[0][0]; r[0][1] = sdm[1][0];
+      r[1][0] = sdm[0][1]; r[1][1] = sdm[1][1];
+   }
+   else {
+      r[0][0] = sdm[0][0]; r[0][1] = sdm[0][1];
+      r[1][0] = sdm[1][0]; r[1][1] = sdm[1][1];
+   }
+   const Int_t stride = 1 << (fLegs - 1 - leg);
+   const Int_t size = 1 << fLegs;
+   for (Int_t i0=0; i0 < size; i0 += 2*stride) {
+      for (Int_t i=i0; i < i0 + stride; i++) {
+         Complex_t w0 = w[i];
+         Complex_t w1 = w[i + stride];
+         w[i] = r[0][0] * w0 + r[0][1] * w1;
+         w[i + stride] = r[1][0] * w0 + r[1][1] * w1;
+      }
+   }
+}
+
+Complex_t TAmplitudeTensor::AmpSquared(const TPauliMatrix *const *sdm) const
+{
+   // Returns the sum over all helicity states of M M* weighted by the
+   // spin-density matrices sdm[l] of the external legs, listed in leg
+   // order.  A null pointer in sdm[l] is treated as the unit matrix,
+   // that is a sum over the polarization states of leg l.  The result
+   // should be real and non-negative for hermetian positive sdm inputs.
+
+   const Int_t size = 1 << fLegs;
+   Complex_t w[1 << kMaxLegs];
+   for (Int_t i=0; i < size; i++)
+      w[i] = conj(fAmp[i]);
+   for (Int_t leg=0; leg < fLegs; leg++)
+      if (sdm[leg])
+         ApplySDM(w, leg, *sdm[leg]);
+   Complex_t ampSquared(0);
+   for (Int_t i=0; i < size; i++)
+      ampSquared += fAmp[i] * w[i];
+   return ampSquared;
+}
+
+TPauliMatrix TAmplitudeTensor::Response(const Int_t leg,
+                                        const TPauliMatrix *const *sdm) const
+{
+   // Returns the 2x2 matrix X(h,hbar) obtained by contracting all legs
+   // except leg with their sdm, and leaving the helicity indices of leg
+   // open.  The result is multiplied by the kinematical factor, so that
+   // for a final-state leg it is the spin-density matrix of that
+   // particle normalized to the differential cross section summed over
+   // its polarization states (Trace() returns the cross section, and
+   // Decompose() gives its polarization).  For an initial-state leg it
+   // is the response matrix, such that the cross section for an initial
+   // SDM rho is Trace(rho X^T).  The entry sdm[leg] is ignored.
+
+   TPauliMatrix result(0);
+   if (leg < 0 || leg >= fLegs) {
+      Error("TAmplitudeTensor::Response","leg index out of range");
+      return result;
+   }
+   const Int_t size = 1 << fLegs;
+   const Int_t stride = 1 << (fLegs - 1 - leg);
+   Complex_t w[1 << kMaxLegs];
+   for (Int_t i=0; i < size; i++)
+      w[i] = conj(fAmp[i]);
+   for (Int_t l=0; l < fLegs; l++)
+      if (l != leg && sdm[l])
+         ApplySDM(w, l, *sdm[l]);
+   Complex_t x[2][2] = {{Complex_t(0), Complex_t(0)},
+                        {Complex_t(0), Complex_t(0)}};
+   for (Int_t i=0; i < size; i++) {
+      if (i & stride)
+         continue;
+      x[0][0] += fAmp[i] * w[i];
+      x[0][1] += fAmp[i] * w[i + stride];
+      x[1][0] += fAmp[i + stride] * w[i];
+      x[1][1] += fAmp[i + stride] * w[i + stride];
+   }
+   for (Int_t i=0; i < 2; i++)
+      for (Int_t j=0; j < 2; j++)
+         result[i][j] = x[i][j] * fKinFactor;
+   return result;
+}
+
+Int_t TAmplitudeTensor::Sample(const TPauliMatrix *const *sdm,
+                               const Int_t legMask, const Double_t u,
+                               LDouble_t *diffXS) const
+{
+   // Chooses a helicity state for each of the legs selected by legMask
+   // (bit l set for leg l) with probability proportional to |M|^2, with
+   // all other legs contracted with their sdm as in AmpSquared.  The
+   // random number u should be uniform on [0,1).  The return value is
+   // a flat amplitude index with the chosen helicities in the bits of
+   // the selected legs, and zeros elsewhere, so that the helicity of leg
+   // l can be read back with Helicity(index,l).  The joint probabilities
+   // of the selected legs are fully correlated, as they would be for
+   // separate evaluations of the cross section for each configuration.
+   // If diffXS is not null, it is set to the cross section summed over
+   // the helicities of the selected legs.  A return value of -1 means
+   // that the cross section vanishes and no state could be chosen.
+
+   const Int_t size = 1 << fLegs;
+   const Int_t imask = IndexMask(legMask);
+   Complex_t w[1 << kMaxLegs];
+   for (Int_t i=0; i < size; i++)
+      w[i] = conj(fAmp[i]);
+   for (Int_t leg=0; leg < fLegs; leg++)
+      if (((legMask >> leg) & 1) == 0 && sdm[leg])
+         ApplySDM(w, leg, *sdm[leg]);
+   LDouble_t prob[1 << kMaxLegs];
+   for (Int_t i=0; i < size; i++)
+      prob[i] = 0;
+   LDouble_t total = 0;
+   for (Int_t i=0; i < size; i++) {
+      LDouble_t p = real(fAmp[i] * w[i]);
+      prob[i & imask] += p;
+      total += p;
+   }
+   if (diffXS)
+      *diffXS = fKinFactor * total;
+   if (!(total > 0))
+      return -1;
+   LDouble_t cut = u * total;
+   LDouble_t sum = 0;
+   Int_t last = -1;
+   for (Int_t i=0; i < size; i++) {
+      if ((i & ~imask) || prob[i] <= 0)
+         continue;
+      sum += prob[i];
+      last = i;
+      if (sum > cut)
+         break;
+   }
+   return last;
+}
+
+void TAmplitudeTensor::Density(const TPauliMatrix *const *sdm,
+                               const Int_t legMask, Complex_t *rho) const
+{
+   // Computes the joint spin-density matrix of the k legs selected by
+   // legMask (bit l set for leg l), with all other legs contracted with
+   // their sdm as in AmpSquared.  On return rho[f*2^k + fbar] holds the
+   // element (f,fbar), where f and fbar list the helicities of the
+   // selected legs in leg order, leg with the lowest index first.  The
+   // result is multiplied by the kinematical factor, so that its trace
+   // is the differential cross section summed over the helicities of the
+   // selected legs.  For a single final-state leg rho is the same matrix
+   // as Response returns.  The array rho must have room for 4^k entries.
+
+   const Int_t size = 1 << fLegs;
+   const Int_t imask = IndexMask(legMask);
+   Complex_t w[1 << kMaxLegs];
+   for (Int_t i=0; i < size; i++)
+      w[i] = conj(fAmp[i]);
+   for (Int_t leg=0; leg < fLegs; leg++)
+      if (((legMask >> leg) & 1) == 0 && sdm[leg])
+         ApplySDM(w, leg, *sdm[leg]);
+
+   // compact index of the selected legs for each flat index
+   Int_t compact[1 << kMaxLegs];
+   Int_t nsel = 0;
+   for (Int_t i=0; i < size; i++) {
+      compact[i] = 0;
+      for (Int_t leg=0; leg < fLegs; leg++)
+         if ((legMask >> leg) & 1)
+            compact[i] = (compact[i] << 1) + Helicity(i,leg);
+   }
+   for (Int_t leg=0; leg < fLegs; leg++)
+      nsel += (legMask >> leg) & 1;
+   const Int_t dim = 1 << nsel;
+   for (Int_t f=0; f < dim*dim; f++)
+      rho[f] = 0;
+   for (Int_t i=0; i < size; i++) {
+      for (Int_t ibar=0; ibar < size; ibar++) {
+         if ((i & ~imask) == (ibar & ~imask))
+            rho[compact[i]*dim + compact[ibar]] += fAmp[i] * w[ibar];
+      }
+   }
+   for (Int_t f=0; f < dim*dim; f++)
+      rho[f] *= fKinFactor;
+}
+
+Int_t TAmplitudeTensor::PackResponse(const TPauliMatrix *const *sdm,
+                                     const Int_t legMask,
+                                     Double_t *packed) const
+{
+   // Stores the response of the cross section to the spin-density
+   // matrices of the k initial-state legs selected by legMask, with all
+   // other legs contracted with their sdm as in AmpSquared.  The response
+   // X is the matrix computed by Density, which is hermetian, so it is
+   // packed into 4^k real numbers: packed[i*2^k + j] = Re X(i,j) for
+   // j >= i, and Im X(j,i) for j < i.  The cross section for any other
+   // choice of SDMs on the selected legs is then obtained from the packed
+   // array alone by ContractPacked.  The return value is 4^k.
+
+   Int_t nsel = 0;
+   for (Int_t leg=0; leg < fLegs; leg++)
+      nsel += (legMask >> leg) & 1;
+   const Int_t dim = 1 << nsel;
+   Complex_t buffer[kStackValues];
+   std::vector<Complex_t> heap;
+   Complex_t *rho = buffer;
+   if (dim*dim > kStackValues) {
+      heap.resize(dim*dim);
+      rho = &heap[0];
+   }
+   Density(sdm, legMask, rho);
+   for (Int_t i=0; i < dim; i++) {
+      for (Int_t j=0; j < dim; j++) {
+         if (j >= i)
+            packed[i*dim + j] = (Double_t)real(rho[i*dim + j]);
+         else
+            packed[i*dim + j] = (Double_t)imag(rho[j*dim + i]);
+      }
+   }
+   return dim*dim;
+}
+
+Int_t TAmplitudeTensor::PackContraction(const TPauliMatrix *const *sdm,
+                                        const Int_t nsel, LDouble_t *coeff)
+{
+   // Computes the coefficients that contract a response packed by
+   // PackResponse with the spin-density matrices sdm[0..nsel-1] of the
+   // selected initial-state legs, listed in leg order, so that the cross
+   // section is the sum of coeff[f]*packed[f] over the 4^nsel values.
+   // They depend only on the sdm, so they can be computed once for all
+   // of the events in a sample.  A null pointer in sdm is treated as the
+   // unit matrix, as in AmpSquared.  The return value is 4^nsel.
+
+   const Int_t dim = 1 << nsel;
+   for (Int_t i=0; i < dim; i++) {
+      for (Int_t j=i; j < dim; j++) {
+         Complex_t r(1);
+         for (Int_t l=0; l < nsel; l++) {
+            Int_t hi = (i >> (nsel - 1 - l)) & 1;
+            Int_t hj = (j >> (nsel - 1 - l)) & 1;
+            if (sdm[l])
+               r *= (*sdm[l])[hi][hj];
+            else if (hi != hj)
+               r = 0;
+         }
+         if (i == j) {
+            coeff[i*dim + i] = real(r);
+         }
+         else {
+            coeff[i*dim + j] = 2 * real(r);
+            coeff[j*dim + i] = -2 * imag(r);
+         }
+      }
+   }
+   return dim*dim;
+}
+
+LDouble_t TAmplitudeTensor::ContractPacked(const Double_t *packed,
+                                           const Int_t nsel,
+                                           const LDouble_t *coeff)
+{
+   // Contracts a response packed by PackResponse with the coefficients
+   // computed by PackContraction, and returns the cross section.
+
+   const Int_t nvalues = 1 << (2*nsel);
+   LDouble_t result = 0;
+   for (Int_t f=0; f < nvalues; f++)
+      result += coeff[f] * packed[f];
+   return result;
+}
+
+LDouble_t TAmplitudeTensor::ContractPacked(const Double_t *packed,
+                                           const Int_t nsel,
+                                           const TPauliMatrix *const *sdm)
+{
+   // Contracts a response packed by PackResponse with the spin-density
+   // matrices sdm[0..nsel-1] of the selected initial-state legs, listed
+   // in leg order, and returns the cross section.  When many responses
+   // are contracted with the same sdm, it is faster to call
+   // PackContraction once and use the other form of ContractPacked.
+
+   LDouble_t buffer[kStackValues];
+   std::vector<LDouble_t> heap;
+   LDouble_t *coeff = buffer;
+   if ((1 << (2*nsel)) > kStackValues) {
+      heap.resize(1 << (2*nsel));
+      coeff = &heap[0];
+   }
+   PackContraction(sdm, nsel, coeff);
+   return ContractPacked(packed, nsel, coeff);
+}
+
+Int_t TAmplitudeTensor::IndexMask(const Int_t legMask) const
+{
+   // Converts a mask of legs (bit l set for leg l) into the mask of the
+   // corresponding bits in the flat amplitude index.
+
+   Int_t imask = 0;
+   for (Int_t leg=0; leg < fLegs; leg++)
+      if ((legMask >> leg) & 1)
+         imask |= 1 << (fLegs - 1 - leg);
+   return imask;
+}
+
+void TAmplitudeTensor::Streamer(TBuffer &buf)
+{
+   // Put/get a TAmplitudeTensor object to/from stream buffer buf.
+
+   TAmplitudeTensor *me=this;
+   if (buf.IsReading()) {
+      buf >> me;
+   } else {
+      buf << me;
+   }
+}
+
+void TAmplitudeTensor::Print(Option_t *option)
+{
+   // Output the amplitude tensor in ascii form, one helicity
+   // configuration per line.
+
+   std::cout << "TAmplitudeTensor with " << fLegs << " legs, "
+             << "kinematic factor " << fKinFactor << std::endl;
+   for (Int_t i=0; i < (1 << fLegs); i++) {
+      std::cout << "  M(";
+      for (Int_t leg=0; leg < fLegs; leg++) {
+         std::cout << (((i >> (fLegs - 1 - leg)) & 1)? "-" : "+")
+                   << ((IsFinal(leg))? "'" : "");
+      }
+      std::cout << ") = " << fAmp[i] << std::endl;
+   }
+}
@@ -0,0 +1,200 @@
+//
+// TAmplitudeTensor.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+
+#ifndef ROOT_TAmplitudeTensor
+#define ROOT_TAmplitudeTensor
+
+#include "Double.h"
+#include "Complex.h"
+#include "TBuffer.h"
+#include "TPauliMatrix.h"
+#include "TError.h"
+
+
+class TAmplitudeTensor {
+
+// The TAmplitudeTensor class holds the full set of tree-level helicity
+// amplitudes M(h0,h1,...) for a process with up to kMaxLegs polarized
+// external legs, together with the kinematical factor that converts
+// |M|^2 into the differential cross section returned by TCrossSection.
+// Leg l has helicity index h_l = 0 (+1/2 or r.h.) or 1 (-1/2 or l.h.),
+// and leg 0 is the most significant bit of the flat amplitude index,
+// so that the layout is identical to a C array Amp[2][2]...[2].
+
+public:
+   enum { kMaxLegs = 6 };
+
+protected:
+   Int_t      fLegs;                  // number of polarized external legs
+   Int_t      fFinalMask;             // bit l set if leg l is in final state
+   LDouble_t  fKinFactor;             // factor converting |M|^2 to diffXS
+   Complex_t  fAmp[1 << kMaxLegs];    // helicity amplitudes
+
+public:
+   TAmplitudeTensor() : fLegs(0), fFinalMask(0), fKinFactor(0) { }
+   explicit TAmplitudeTensor(const Int_t legs, const Int_t finalMask);
+   TAmplitudeTensor(const TAmplitudeTensor &another);
+
+   virtual ~TAmplitudeTensor() { }
+
+   Complex_t &operator[](Int_t index) const;
+
+   Int_t Legs() const;
+   Int_t Size() const;
+   Bool_t IsFinal(Int_t leg) const;
+   Int_t FinalMask() const;
+   Int_t Index(const Int_t *helicities) const;
+   Int_t Helicity(const Int_t index, const Int_t leg) const;
+   LDouble_t KinFactor() const;
+
+   TAmplitudeTensor &operator=(const TAmplitudeTensor &source);
+   TAmplitudeTensor &SetLegs(const Int_t legs, const Int_t finalMask);
+   TAmplitudeTensor &SetKinFactor(const LDouble_t factor);
+   TAmplitudeTensor &Zero();
+
+   Complex_t AmpSquared(const TPauliMatrix *const *sdm) const;
+   LDouble_t Contract(const TPauliMatrix *const *sdm) const;
+   TPauliMatrix Response(const Int_t leg, const TPauliMatrix *const *sdm) const;
+   Int_t Sample(const TPauliMatrix *const *sdm, const Int_t legMask,
+                const Double_t u, LDouble_t *diffXS=0) const;
+   void Density(const TPauliMatrix *const *sdm, const Int_t legMask,
+                Complex_t *rho) const;
+   Int_t PackResponse(const TPauliMatrix *const *sdm, const Int_t legMask,
+                      Double_t *packed) const;
+   static LDouble_t ContractPacked(const Double_t *packed, const Int_t nsel,
+                                   const TPauliMatrix *const *sdm);
+   static LDouble_t ContractPacked(const Double_t *packed, const Int_t nsel,
+                                   const LDouble_t *coeff);
+   static Int_t PackContraction(const TPauliMatrix *const *sdm,
+                                const Int_t nsel, LDouble_t *coeff);
+
+   friend TBuffer &operator>>(TBuffer &buf, TAmplitudeTensor *&obj);
+   friend TBuffer &operator<<(TBuffer &buf, const TAmplitudeTensor *obj);
+   void Print(Option_t *option="");
+
+   ClassDef(TAmplitudeTensor,1)  // Helicity amplitudes of a QED process
+
+protected:
+   void ApplySDM(Complex_t *w, const Int_t leg, const TPauliMatrix &sdm) const;
+   Int_t IndexMask(const Int_t legMask) const;
+};
+
+//----- inlines ----------------------------------------------------------------
+
+inline TAmplitudeTensor::TAmplitudeTensor(const Int_t legs,
+                                          const Int_t finalMask)
+{
+   fKinFactor = 0;
+   SetLegs(legs, finalMask);
+}
+
+inline TAmplitudeTensor::TAmplitudeTensor(const TAmplitudeTensor &another)
+{
+   *this = another;
+}
+
+inline Complex_t &TAmplitudeTensor::operator[](Int_t index) const
+{
+   return (Complex_t &)fAmp[index];
+}
+
+inline Int_t TAmplitudeTensor::Legs() const
+{
+   return fLegs;
+}
+
+inline Int_t TAmplitudeTensor::Size() const
+{
+   return 1 << fLegs;
+}
+
+inline Bool_t TAmplitudeTensor::IsFinal(Int_t leg) const
+{
+   return (fFinalMask >> leg) & 1;
+}
+
+inline Int_t TAmplitudeTensor::FinalMask() const
+{
+   return fFinalMask;
+}
+
+inline Int_t TAmplitudeTensor::Index(const Int_t *helicities) const
+{
+   Int_t index = 0;
+   for (Int_t leg=0; leg < fLegs; leg++)
+      index = (index << 1) + helicities[leg];
+   return index;
+}
+
+inline Int_t TAmplitudeTensor::Helicity(const Int_t index,
+                                        const Int_t leg) const
+{
+   return (index >> (fLegs - 1 - leg)) & 1;
+}
+
+inline LDouble_t TAmplitudeTensor::KinFactor() const
+{
+   return fKinFactor;
+}
+
+inline TAmplitudeTensor &TAmplitudeTensor::operator=
+                        (const TAmplitudeTensor &source)
+{
+   fLegs = source.fLegs;
+   fFinalMask = source.fFinalMask;
+   fKinFactor = source.fKinFactor;
+   for (Int_t i=0; i < (1 << fLegs); i++)
+      fAmp[i] = source.fAmp[i];
+   return *this;
+}
+
+inline TAmplitudeTensor &TAmplitudeTensor::SetKinFactor(const LDouble_t factor)
+{
+   fKinFactor = factor;
+   return *this;
+}
+
+inline TAmplitudeTensor &TAmplitudeTensor::Zero()
+{
+   for (Int_t i=0; i < (1 << fLegs); i++)
+      fAmp[i] = 0;
+   return *this;
+}
+
+inline LDouble_t TAmplitudeTensor::Contract(const TPauliMatrix *const *sdm) const
+{
+   return fKinFactor * real(AmpSquared(sdm));
+}
+
+inline TBuffer &operator>>(TBuffer &buf, TAmplitudeTensor *&obj)
+{
+   Int_t legs, finalMask;
+   Double_t kinFactor;
+   buf >> legs >> finalMask >> kinFactor;
+   obj->SetLegs(legs, finalMask);
+   obj->fKinFactor = kinFactor;
+   for (Int_t i=0; i < obj->Size(); i++) {
+      Double_t real,imag;
+      buf >> real >> imag;
+      obj->fAmp[i] = Complex_t(real,imag);
+   }
+   return buf;
+}
+
+inline TBuffer &operator<<(TBuffer &buf, const TAmplitudeTensor *obj)
+{
+   Double_t kinFactor = (Double_t)obj->fKinFactor;
+   buf << obj->fLegs << obj->fFinalMask << kinFactor;
+   for (Int_t i=0; i < obj->Size(); i++) {
+      Double_t real = (Double_t)obj->fAmp[i].real();
+      Double_t imag = (Double_t)obj->fAmp[i].imag();
+      buf << real << imag;
+   }
+   return buf;
+}
+
+#endif
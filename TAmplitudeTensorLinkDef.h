@@ -0,0 +1,4 @@
+#pragma link C++ class TAmplitudeTensor-;
+
+#pragma link C++ function operator>>(TBuffer&,TAmplitudeTensor*&);
+#pragma link C++ function operator<<(TBuffer&,const TAmplitudeTensor*);
@@ -113,9 +113,24 @@
 //
 //////////////////////////////////////////////////////////////////////////
 
+// Checks on |M|^2 in the cross section functions are counted by the
+// diagnostics below, see PrintDiagnostics.  For a performance build,
+// compile with -DDEBUGGING=0 to remove the checks entirely.
+#ifndef DEBUGGING
 #define DEBUGGING 1
+#endif
+
+// The cross section functions are split into timed sections for the
+// kinematics, spinors, propagators, amplitude products and spin sums
+// when compiled with -DDIRACXX_PROFILE, see SetProfiling and Profiler.h.
 
 #include <iostream>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <memory>
+#include <cfloat>
+#include <algorithm>
 #include "TCrossSection.h"
 
 ClassImp(TCrossSection)
@@ -123,12 +138,266 @@ ClassImp(TCrossSection)
 #include "TPhoton.h"
 #include "TLepton.h"
 #include "TLorentzBoost.h"
+#include "TAmplitudeTensor.h"
+#include "Profiler.h"
 
 const LDouble_t PI_=2*atan2(1.,0.);
 
 inline LDouble_t sqr(LDouble_t x) { return x*x; }
 inline Complex_t sqr(Complex_t x) { return x*x; }
 
+// The amplitudes are validated on a sampled subset of calls, 1 in every
+// validationStride calls on each thread, see SetValidation.  The checks
+// are counted in lock-free counters shared by all threads.  While the
+// Ward identity is being checked for one external photon leg, wardLeg
+// is set to that leg, and PhotonEps returns the photon momentum in place
+// of its polarization vector, as TGhoston does.
+
+static std::atomic<ULong64_t> validationCount[TCrossSection::kValidationTypes];
+static std::atomic<UInt_t> validationStride(10000);
+static std::atomic<Double_t> validationTolerance(1e-6);
+static thread_local UInt_t validationCalls = 0;
+static thread_local Int_t wardLeg = -1;
+
+inline Bool_t ValidationDue()
+{
+   UInt_t stride = validationStride.load(std::memory_order_relaxed);
+   if (stride == 0 || ++validationCalls < stride)
+      return 0;
+   validationCalls = 0;
+   return 1;
+}
+
+inline TFourVectorComplex PhotonEps(const TPhoton *g, const Int_t leg,
+                                    const Int_t mode)
+{
+   return (leg == wardLeg)? TFourVectorComplex(g->Mom()) : g->Eps(mode);
+}
+
+inline TFourVectorComplex PhotonEpsStar(const TPhoton *g, const Int_t leg,
+                                        const Int_t mode)
+{
+   return (leg == wardLeg)? TFourVectorComplex(g->Mom()) : g->EpsStar(mode);
+}
+
+// Failed |M|^2 checks are counted per thread, in a block of counters
+// that each thread allocates on its first use and registers in a
+// global list, so that nothing is shared between threads until the
+// report is made.  The list owns the blocks, which outlive the threads
+// so that their counts stay in the report, and frees them at exit.
+// The first few inputs that fail each check on each thread are also
+// saved as exemplars.  At most diagnosticPrintLimit warnings of each
+// type are printed immediately, over all threads.  The same blocks hold
+// the counts of the adaptive precision checks, see SetEscalation.
+
+struct DiagnosticExemplar {
+   Complex_t       ampSquared;     // value of |M|^2 that failed
+   Int_t           nmom;           // number of four-momenta saved
+   LDouble_t       mom[6][4];      // four-momenta of the external legs
+};
+
+struct DiagnosticBlock {
+   enum { kMaxExemplars = 4 };
+   std::atomic<ULong64_t> count[TCrossSection::kDiagnosticTypes];
+   std::atomic<Int_t> nexemplar[TCrossSection::kDiagnosticTypes];
+   DiagnosticExemplar exemplar[TCrossSection::kDiagnosticTypes]
+                              [kMaxExemplars];
+   std::atomic<ULong64_t> escalation[TCrossSection::kEscalationTypes];
+};
+
+static std::mutex diagnosticLock;
+static std::vector<std::unique_ptr<DiagnosticBlock> > diagnosticBlocks;
+static std::atomic<Int_t> diagnosticPrinted[TCrossSection::kDiagnosticTypes];
+static std::atomic<Int_t> diagnosticPrintLimit(1);
+
+static thread_local DiagnosticBlock *diagnosticBlock = 0;
+
+static DiagnosticBlock *ThreadDiagnostics()
+{
+   // Returns the diagnostic block of the calling thread, allocating
+   // and registering it the first time.
+
+   if (diagnosticBlock == 0) {
+      diagnosticBlock = new DiagnosticBlock;
+      for (Int_t i=0; i < TCrossSection::kDiagnosticTypes; i++) {
+         diagnosticBlock->count[i] = 0;
+         diagnosticBlock->nexemplar[i] = 0;
+      }
+      for (Int_t i=0; i < TCrossSection::kEscalationTypes; i++)
+         diagnosticBlock->escalation[i] = 0;
+      std::lock_guard<std::mutex> guard(diagnosticLock);
+      diagnosticBlocks.push_back(
+                       std::unique_ptr<DiagnosticBlock>(diagnosticBlock));
+   }
+   return diagnosticBlock;
+}
+
+static void CountDiagnostic(std::atomic<ULong64_t> &counter)
+{
+   // Increments a counter that is only written by the owning thread.
+
+   ULong64_t count = counter.load(std::memory_order_relaxed);
+   counter.store(count + 1, std::memory_order_relaxed);
+}
+
+#if DEBUGGING
+static const char *diagnosticName[TCrossSection::kDiagnosticTypes] = {
+   "Bremsstrahlung", "PairProduction", "TripletProduction",
+   "BetheHeitlerNucleon", "eeBremsstrahlung", "ePairProduction",
+   "eTripletProduction"
+};
+
+static void ReportDiagnostic(const TCrossSection::EDiagnostic type,
+                             const Complex_t &ampSquared,
+                             const TFourVectorReal *mom, const Int_t nmom)
+{
+   // Records one failed |M|^2 check of the given type, with the momenta
+   // of the external legs that produced it.
+
+   DiagnosticBlock *block = ThreadDiagnostics();
+   CountDiagnostic(block->count[type]);
+   Int_t n = block->nexemplar[type].load(std::memory_order_relaxed);
+   if (n < DiagnosticBlock::kMaxExemplars) {
+      DiagnosticExemplar &ex = block->exemplar[type][n];
+      ex.ampSquared = ampSquared;
+      ex.nmom = (nmom < 6)? nmom : 6;
+      for (Int_t i=0; i < ex.nmom; i++)
+         for (Int_t mu=0; mu < 4; mu++)
+            ex.mom[i][mu] = mom[i][mu];
+      block->nexemplar[type].store(n + 1, std::memory_order_release);
+   }
+   // the shared print counter is only touched until the limit is reached,
+   // so that it is not contended, and cannot wrap, in a bad region
+   Int_t limit = diagnosticPrintLimit.load(std::memory_order_relaxed);
+   if (diagnosticPrinted[type].load(std::memory_order_relaxed) < limit &&
+       diagnosticPrinted[type]++ < limit)
+   {
+      std::lock_guard<std::mutex> guard(diagnosticLock);
+      std::cout << "Warning: bad " << diagnosticName[type]
+                << " amplitudes, ampSquared = " << ampSquared
+                << " should be real positive"
+                << " (further warnings are counted, see"
+                << " TCrossSection::PrintDiagnostics)" << std::endl;
+   }
+}
+#endif
+
+static void ValidateAmplitude(const TAmplitudeTensor &amp,
+                              const TPauliMatrix *const *sdm,
+                              const TAmplitudeTensor *ward,
+                              const LDouble_t *wardScale,
+                              const Int_t nward)
+{
+   // Checks one set of amplitudes, and counts any violations found.
+   //  (1) Ward identity: ward[n] holds the amplitudes recomputed with
+   //      the polarization of one external photon replaced by its
+   //      momentum, which should vanish.  Their norm is compared with
+   //      the norm of amp times wardScale[n], the photon energy.
+   //  (2) hermiticity: the density matrix of each leg, with all other
+   //      legs contracted with sdm, must be hermetian, and |M|^2 real.
+   //  (3) positivity: |M|^2 and the diagonal elements and determinant
+   //      of each leg density matrix must be non-negative.
+
+   const LDouble_t tol = validationTolerance.load(std::memory_order_relaxed);
+   validationCount[TCrossSection::kValidationChecks]++;
+
+   LDouble_t norm = 0;
+   for (Int_t i=0; i < amp.Size(); i++)
+      norm += std::norm(amp[i]);
+   for (Int_t n=0; n < nward; n++) {
+      LDouble_t wnorm = 0;
+      for (Int_t i=0; i < ward[n].Size(); i++)
+         wnorm += std::norm(ward[n][i]);
+      if (wnorm > sqr(tol * wardScale[n]) * norm) {
+         validationCount[TCrossSection::kValidationWard]++;
+         break;
+      }
+   }
+
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+   Bool_t hermetian = fabs(ampSquared.imag()) <= tol * fabs(ampSquared);
+   Bool_t positive = real(ampSquared) >= -tol * fabs(ampSquared);
+   for (Int_t leg=0; leg < amp.Legs(); leg++) {
+      TPauliMatrix rho(amp.Response(leg, sdm));
+      LDouble_t trace = fabs(rho[0][0]) + fabs(rho[1][1]);
+      if (fabs(rho[0][0].imag()) > tol * trace ||
+          fabs(rho[1][1].imag()) > tol * trace ||
+          abs(rho[0][1] - conj(rho[1][0])) > tol * trace)
+      {
+         hermetian = 0;
+      }
+      if (real(rho[0][0]) < -tol * trace ||
+          real(rho[1][1]) < -tol * trace ||
+          real(rho[0][0] * rho[1][1] - rho[0][1] * rho[1][0])
+                                     < -tol * sqr(trace))
+      {
+         positive = 0;
+      }
+   }
+   if (!hermetian)
+      validationCount[TCrossSection::kValidationHermiticity]++;
+   if (!positive)
+      validationCount[TCrossSection::kValidationPositivity]++;
+}
+
+// In the adaptive precision mode, see SetEscalation, the Compton,
+// Bremsstrahlung, PairProduction and TripletProduction amplitudes record
+// the condition of their kinematics on the calling thread, the factor by
+// which relative rounding errors in the momenta are amplified in the
+// amplitudes, from the cancellations in the propagator denominators of
+// nearly collinear legs and between the diagrams at small recoil.  The
+// relative error of |M|^2 is then estimated by RoundingError as the unit
+// roundoff of LDouble_t times this condition, times the ratio of the sum
+// of the magnitudes of the terms in the contraction of |M|^2 to the sum
+// itself.  This is meant to be evaluated in the fast double build, so
+// that the few events whose estimate exceeds the tolerance can be
+// recomputed in the long double or quad precision builds, as is done
+// by precision.cxx.
+
+#if defined DIRACXX_DOUBLE
+static const Double_t roundingUnit = DBL_EPSILON;
+#elif defined DIRACXX_DOUBLE_DOUBLE
+static const Double_t roundingUnit = 4.93e-32;     // 2^-104
+#elif defined DIRACXX_FLOAT128
+static const Double_t roundingUnit = 1.93e-34;     // 2^-112
+#else
+static const Double_t roundingUnit = LDBL_EPSILON;
+#endif
+
+static std::atomic<Double_t> escalationTolerance(0);
+static thread_local Double_t escalationCondition = 1;
+static thread_local Bool_t escalationFlag = 0;
+
+inline Bool_t EscalationOn()
+{
+   return escalationTolerance.load(std::memory_order_relaxed) > 0;
+}
+
+inline Double_t ProductCondition(TFourVectorReal a, TFourVectorReal b)
+{
+   // Returns the factor by which relative errors in a and b are amplified
+   // in the scalar product a.b, as in a propagator denominator.
+
+   LDouble_t terms = fabs(a[0]*b[0]) + fabs(a[1]*b[1])
+                   + fabs(a[2]*b[2]) + fabs(a[3]*b[3]);
+   LDouble_t prod = fabs(a.ScalarProd(b));
+   return (Double_t)((prod > terms*roundingUnit)? terms/prod : 1/roundingUnit);
+}
+
+inline Double_t RecoilCondition(const TFourVectorReal &q,
+                                const LDouble_t mass)
+{
+   // Returns the factor m/|q| by which the diagrams in which a virtual
+   // photon of momentum q is absorbed by a lepton of mass m cancel as q
+   // goes to zero, as required by gauge invariance, or 1 if |q| > m.
+
+   LDouble_t q2 = fabs(q.InvariantSqr());
+   if (q2 >= sqr(mass))
+      return 1;
+   return (q2 > sqr(mass*roundingUnit))? (Double_t)(mass/sqrt(q2))
+                                       : 1/roundingUnit;
+}
+
 LDouble_t TCrossSection::Compton(const TPhoton &gIn, const TLepton &eIn,
                                  const TPhoton &gOut, const TLepton &eOut)
 {
@@ -137,6 +406,58 @@ LDouble_t TCrossSection::Compton(const TPhoton &gIn, const TLepton &eIn,
    // in solid angle of the scattered photon, where the solid angle is
    // that of the photon in the frame chosen by the user.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::Compton");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   ComptonAmplitude(gIn, eIn, gOut, eOut, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Average over initial and final spins
+   const TPauliMatrix *sdm[4] = {&gIn.SDM(), &eIn.SDM(),
+                                 &gOut.SDM(), &eOut.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+   if (EscalationOn())
+      Escalate(amp, sdm);
+   LDouble_t diffXsect = amp.KinFactor()*real(ampSquared);
+
+   if (ValidationDue()) {
+      DIRACXX_PROFILE_SECTION("validation");
+      TAmplitudeTensor ward[2];
+      wardLeg = 0;
+      ComptonAmplitude(gIn, eIn, gOut, eOut, ward[0]);
+      wardLeg = 2;
+      ComptonAmplitude(gIn, eIn, gOut, eOut, ward[1]);
+      wardLeg = -1;
+      LDouble_t scale[2] = {gIn.Mom()[0], gOut.Mom()[0]};
+      ValidateAmplitude(amp, sdm, ward, scale, 2);
+   }
+   return diffXsect;
+
+   // The unpolarized Klein Nishina formula is here for comparison
+   const LDouble_t mLepton = eIn.Mass();
+   LDouble_t sinSqrTheta = 1 - sqr(gOut.Mom()[3]/gOut.Mom()[0]);
+   LDouble_t KleinNishinaResult = sqr(alphaQED/mLepton)/2;
+   KleinNishinaResult *= sqr(gOut.Mom()[0]/gIn.Mom()[0]);
+   KleinNishinaResult *= (gOut.Mom()[0]/gIn.Mom()[0]) +
+                         (gIn.Mom()[0]/gOut.Mom()[0]) - sinSqrTheta;
+   KleinNishinaResult *= hbarcSqr;
+   return KleinNishinaResult;
+}
+
+void TCrossSection::ComptonAmplitude(const TPhoton &gIn, const TLepton &eIn,
+                                     const TPhoton &gOut, const TLepton &eOut,
+                                     TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for Compton scattering of a photon
+   // from a free lepton, and stores them in amp together with the factor
+   // that converts |M|^2 into the differential cross section returned by
+   // Compton().  The legs of amp are numbered in argument order, that is
+   // 0=gIn, 1=eIn, 2=gOut, 3=eOut.  The polarization states of the input
+   // arguments are ignored, so that any number of polarization observables
+   // can be obtained from one call by contracting amp with different SDMs.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::ComptonAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TPhoton gIncoming(gIn),  *gI=&gIncoming;
    TLepton eIncoming(eIn),  *eI=&eIncoming;
    TPhoton gOutgoing(gOut), *gF=&gOutgoing;
@@ -151,6 +472,7 @@ LDouble_t TCrossSection::Compton(const TPhoton &gIn, const TLepton &eIn,
    eF->SetMom(eF->Mom().Boost(btest));
 *******************************************/
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the initial,final lepton state vectors
    TDiracSpinor uI[2];
    uI[0].SetStateU(eI->Mom(), +0.5);
@@ -162,59 +484,41 @@ LDouble_t TCrossSection::Compton(const TPhoton &gIn, const TLepton &eIn,
    // Assume without checking that initial,final leptons have same mass
    const LDouble_t mLepton = eI->Mass();
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Obtain the electron propagators for the two diagrams
    TDiracMatrix dm;
    LDouble_t edenom1 = +2 * eI->Mom().ScalarProd(gI->Mom());
    LDouble_t edenom2 = -2 * eI->Mom().ScalarProd(gF->Mom());
+   if (EscalationOn()) {
+      escalationCondition = std::max(ProductCondition(eI->Mom(), gI->Mom()),
+                                     ProductCondition(eI->Mom(), gF->Mom()));
+   }
    TDiracMatrix ePropagator1(dm.Slash(eI->Mom() + gI->Mom()) + mLepton);
    TDiracMatrix ePropagator2(dm.Slash(eI->Mom() - gF->Mom()) + mLepton);
    ePropagator1 /= edenom1;
    ePropagator2 /= edenom2;
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
-   const TDiracMatrix gamma0(kDiracGamma0);
-   Complex_t invAmp[2][2][2][2];
+   amp.SetLegs(4, (1 << 2) + (1 << 3));
    for (Int_t gi=0; gi < 2; gi++) {
       for (Int_t gf=0; gf < 2; gf++) {
          TDiracMatrix D;
          TDiracMatrix epsI;
-         epsI.Slash(gI->Eps(gi+1));
+         epsI.Slash(PhotonEps(gI, 0, gi+1));
          TDiracMatrix epsF;
-         epsF.Slash(gF->EpsStar(gf+1));
+         epsF.Slash(PhotonEpsStar(gF, 2, gf+1));
          D = epsF * ePropagator1 * epsI + epsI * ePropagator2 * epsF;
          for (Int_t hi=0; hi < 2; hi++) {
             for (Int_t hf=0; hf < 2; hf++) {
-               invAmp[hi][hf][gi][gf] = uF[hf].ScalarProd(D * uI[hi]);
+               amp[(((gi << 1) + hi) << 2) + (gf << 1) + hf] =
+                                  uF[hf].ScalarProd(D * uI[hi]);
             }
          }
       }
    }
 
-   // Average over initial and final spins
-   Complex_t ampSquared(0);
-   for (Int_t gi=0; gi < 2; gi++) {
-    for (Int_t gibar=0; gibar < 2; gibar++) {
-     for (Int_t gf=0; gf < 2; gf++) {
-      for (Int_t gfbar=0; gfbar < 2; gfbar++) {
-       for (Int_t hi=0; hi < 2; hi++) {
-        for (Int_t hibar=0; hibar < 2; hibar++) {
-         for (Int_t hf=0; hf < 2; hf++) {
-          for (Int_t hfbar=0; hfbar < 2; hfbar++) {
-             ampSquared += invAmp[hi][hf][gi][gf] *
-                 std::conj(invAmp[hibar][hfbar][gibar][gfbar]) *
-                           eI->SDM()[hi][hibar] * 
-                           eF->SDM()[hfbar][hf] *
-                           gI->SDM()[gi][gibar] *
-                           gF->SDM()[gfbar][gf];
-          }
-         }
-        }
-       }
-      }
-     }
-    }
-   }
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux factor from initial state 1/(4*qin*rootS)
    //    (2) rho from density of final states factor
@@ -229,18 +533,7 @@ LDouble_t TCrossSection::Compton(const TPhoton &gIn, const TLepton &eIn,
    const LDouble_t rhoFin = sqr(gF->Mom()[0])/eF->Mom().ScalarProd(gF->Mom())/4;
    const LDouble_t kinFactor = 4*rhoFin/fluxIn;
 
-   LDouble_t diffXsect = hbarcSqr*sqr(alphaQED)*real(ampSquared)*kinFactor;
-
-   return diffXsect;
-
-   // The unpolarized Klein Nishina formula is here for comparison
-   LDouble_t sinSqrTheta = 1 - sqr(gF->Mom()[3]/gF->Mom()[0]);
-   LDouble_t KleinNishinaResult = sqr(alphaQED/mLepton)/2;
-   KleinNishinaResult *= sqr(gF->Mom()[0]/gI->Mom()[0]);
-   KleinNishinaResult *= (gF->Mom()[0]/gI->Mom()[0]) +
-                         (gI->Mom()[0]/gF->Mom()[0]) - sinSqrTheta;
-   KleinNishinaResult *= hbarcSqr;
-   return KleinNishinaResult;
+   amp.SetKinFactor(hbarcSqr*sqr(alphaQED)*kinFactor);
 }
 
 LDouble_t TCrossSection::Bremsstrahlung(const TLepton &eIn,
@@ -260,10 +553,58 @@ LDouble_t TCrossSection::Bremsstrahlung(const TLepton &eIn,
    // depends on the crystal structure of the target atom, and so is left to
    // be carried out by more specialized code.  Units are microbarns/GeV^4/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::Bremsstrahlung");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   BremsstrahlungAmplitude(eIn, eOut, gOut, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Sum over spins
+   const TPauliMatrix *sdm[3] = {&eIn.SDM(), &eOut.SDM(), &gOut.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+   if (EscalationOn())
+      Escalate(amp, sdm);
+
+   if (ValidationDue()) {
+      DIRACXX_PROFILE_SECTION("validation");
+      TAmplitudeTensor ward;
+      wardLeg = 2;
+      BremsstrahlungAmplitude(eIn, eOut, gOut, ward);
+      wardLeg = -1;
+      LDouble_t scale = gOut.Mom()[0];
+      ValidateAmplitude(amp, sdm, &ward, &scale, 1);
+   }
+
+#if DEBUGGING
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
+   {
+      TFourVectorReal mom[3] = {eIn.Mom(), eOut.Mom(), gOut.Mom()};
+      ReportDiagnostic(kDiagBremsstrahlung, ampSquared, mom, 3);
+   }
+#endif
+
+   LDouble_t diffXsect = amp.KinFactor()*real(ampSquared);
+   return diffXsect;
+}
+
+void TCrossSection::BremsstrahlungAmplitude(const TLepton &eIn,
+                                            const TLepton &eOut,
+                                            const TPhoton &gOut,
+                                            TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for bremsstrahlung, and stores them
+   // in amp together with the factor that converts |M|^2 into the
+   // differential cross section returned by Bremsstrahlung().  The legs of
+   // amp are numbered in argument order, 0=eIn, 1=eOut, 2=gOut.  The
+   // polarization states of the input arguments are ignored.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::BremsstrahlungAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TLepton eIncoming(eIn),  *eI=&eIncoming;
    TPhoton gOutgoing(gOut), *gF=&gOutgoing;
    TLepton eOutgoing(eOut), *eF=&eOutgoing;
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the initial,final lepton state vectors
    TDiracSpinor uI[2];
    uI[0].SetStateU(eI->Mom(), +0.5);
@@ -277,68 +618,38 @@ LDouble_t TCrossSection::Bremsstrahlung(const TLepton &eIn,
 
    TFourVectorReal qRecoil(eI->Mom() - eF->Mom() - gF->Mom());
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Obtain the electron propagators for the two diagrams
    TDiracMatrix dm;
    LDouble_t edenom1 = qRecoil.InvariantSqr() - 2 * qRecoil.ScalarProd(eI->Mom());
    LDouble_t edenom2 = qRecoil.InvariantSqr() + 2 * qRecoil.ScalarProd(eF->Mom());
+   if (EscalationOn()) {
+      escalationCondition = std::max(ProductCondition(eI->Mom(), gF->Mom()),
+                                     ProductCondition(eF->Mom(), gF->Mom()))
+                          * RecoilCondition(qRecoil, mLepton);
+   }
    TDiracMatrix ePropagator1 = dm.Slash(eI->Mom() - qRecoil) + mLepton;
    TDiracMatrix ePropagator2 = dm.Slash(eF->Mom() + qRecoil) + mLepton;
    ePropagator1 /= edenom1;
    ePropagator2 /= edenom2;
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
-   Complex_t invAmp[2][2][2];
+   amp.SetLegs(3, (1 << 1) + (1 << 2));
    for (Int_t gf=0; gf < 2; gf++) {
       TDiracMatrix D;
       TDiracMatrix epsF;
-      epsF.Slash(gF->EpsStar(gf+1));
+      epsF.Slash(PhotonEpsStar(gF, 2, gf+1));
       D = epsF * ePropagator1 * gamma0 + gamma0 * ePropagator2 * epsF;
       for (Int_t hi=0; hi < 2; hi++) {
          for (Int_t hf=0; hf < 2; hf++) {
-            invAmp[hi][hf][gf] = uF[hf].ScalarProd(D * uI[hi]);
+            amp[(hi << 2) + (hf << 1) + gf] = uF[hf].ScalarProd(D * uI[hi]);
          }
       }
    }
 
-   // Sum over spins
-   Complex_t ampSquared(0);
-   Complex_t AAbar[2][2] = {0};
-   for (Int_t gf=0; gf < 2; gf++) {
-    for (Int_t gfbar=0; gfbar < 2; gfbar++) {
-     for (Int_t hi=0; hi < 2; hi++) {
-      for (Int_t hibar=0; hibar < 2; hibar++) {
-       for (Int_t hf=0; hf < 2; hf++) {
-        for (Int_t hfbar=0; hfbar < 2; hfbar++) {
-           Complex_t term = invAmp[hi][hf][gf] *
-                  std::conj(invAmp[hibar][hfbar][gfbar]) *
-                            eI->SDM()[hi][hibar] *
-                            eF->SDM()[hfbar][hf] *
-                            gF->SDM()[gfbar][gf];
-           AAbar[gf][gfbar] += term;
-           ampSquared += term;
-        }
-       }
-      }
-     }
-    }
-   }
-
-#if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
-   {
-      std::cout << "Warning: bad Bremsstrahlung amplitudes:" << std::endl
-                << "  These guys should be all real positive:" << std::endl
-                << "    ampSquared = " << ampSquared << std::endl
-                << "    AAbar[0][0] = " << AAbar[0][0] << std::endl
-                << "    AAbar[1][1] = " << AAbar[1][1] << std::endl
-                << "  The rest of these should be conjugate pairs:" << std::endl
-                << "    AAbar[i][j]: " << AAbar[0][1] << ", "
-                                       << AAbar[1][0] <<  std::endl
-      ;
-   }
-#endif
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux factor from initial state 1/(2E)
    //    (2) rho from density of final states factor
@@ -355,9 +666,8 @@ LDouble_t TCrossSection::Bremsstrahlung(const TLepton &eIn,
    // the incoming electron direction.
 
    LDouble_t kinFactor = 1/sqr(2*PI_*eI->Mom()[0]); // |qRecoil| << E/c
-   LDouble_t diffXsect = hbarcSqr*pow(alphaQED,3)*real(ampSquared)
-                         *kinFactor/sqr(qRecoil.InvariantSqr());
-   return diffXsect;
+   amp.SetKinFactor(hbarcSqr*pow(alphaQED,3)
+                    *kinFactor/sqr(qRecoil.InvariantSqr()));
 }
 
 LDouble_t TCrossSection::PairProduction(const TPhoton &gIn,
@@ -377,10 +687,60 @@ LDouble_t TCrossSection::PairProduction(const TPhoton &gIn,
    // depends on the crystal structure of the target atom, and so is left to
    // be carried out by more specialized code.  Units are microbarns/GeV^4/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::PairProduction");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   PairProductionAmplitude(gIn, eOut, pOut, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Sum over spins
+   const TPauliMatrix *sdm[3] = {&gIn.SDM(), &eOut.SDM(), &pOut.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+   if (EscalationOn())
+      Escalate(amp, sdm);
+
+   if (ValidationDue()) {
+      DIRACXX_PROFILE_SECTION("validation");
+      TAmplitudeTensor ward;
+      wardLeg = 0;
+      PairProductionAmplitude(gIn, eOut, pOut, ward);
+      wardLeg = -1;
+      LDouble_t scale = gIn.Mom()[0];
+      ValidateAmplitude(amp, sdm, &ward, &scale, 1);
+   }
+
+#if DEBUGGING
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
+   {
+      TFourVectorReal mom[3] = {gIn.Mom(), eOut.Mom(), pOut.Mom()};
+      ReportDiagnostic(kDiagPairProduction, ampSquared, mom, 3);
+   }
+#endif
+
+   LDouble_t diffXsect = amp.KinFactor()*real(ampSquared);
+   return diffXsect;
+}
+
+void TCrossSection::PairProductionAmplitude(const TPhoton &gIn,
+                                            const TLepton &eOut,
+                                            const TLepton &pOut,
+                                            TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for pair production, and stores them
+   // in amp together with the factor that converts |M|^2 into the
+   // differential cross section returned by PairProduction().  The legs of
+   // amp are numbered in argument order, 0=gIn, 1=eOut, 2=pOut.  The final
+   // positron is described by a v spinor, so its SDM is contracted in the
+   // same way as an initial-state leg, and only leg 1 is flagged as final.
+   // The polarization states of the input arguments are ignored.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::PairProductionAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TPhoton gIncoming(gIn),  *gI=&gIncoming;
    TLepton eOutgoing(eOut), *eF=&eOutgoing;
    TLepton pOutgoing(pOut), *pF=&pOutgoing;
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the two lepton state vectors
    TDiracSpinor uF[2];
    uF[0].SetStateU(eF->Mom(), +0.5);
@@ -394,59 +754,38 @@ LDouble_t TCrossSection::PairProduction(const TPhoton &gIn,
 
    TFourVectorReal qRecoil(gI->Mom() - eF->Mom() - pF->Mom());
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Obtain the electron propagators for the two diagrams
    TDiracMatrix dm;
    LDouble_t edenom1 = -2 * gI->Mom().ScalarProd(eF->Mom());
    LDouble_t edenom2 = -2 * gI->Mom().ScalarProd(pF->Mom());
+   if (EscalationOn()) {
+      escalationCondition = std::max(ProductCondition(gI->Mom(), eF->Mom()),
+                                     ProductCondition(gI->Mom(), pF->Mom()))
+                          * RecoilCondition(qRecoil, mLepton);
+   }
    TDiracMatrix ePropagator1 = dm.Slash(eF->Mom() - gI->Mom()) + mLepton;
    TDiracMatrix ePropagator2 = dm.Slash(gI->Mom() - pF->Mom()) + mLepton;
    ePropagator1 /= edenom1;
    ePropagator2 /= edenom2;
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
-   Complex_t invAmp[2][2][2];
+   amp.SetLegs(3, (1 << 1));
    for (Int_t gi=0; gi < 2; gi++) {
       TDiracMatrix D;
       TDiracMatrix epsI;
-      epsI.Slash(gI->Eps(gi+1));
+      epsI.Slash(PhotonEps(gI, 0, gi+1));
       D = epsI * ePropagator1 * gamma0 + gamma0 * ePropagator2 * epsI;
       for (Int_t hi=0; hi < 2; hi++) {
          for (Int_t hf=0; hf < 2; hf++) {
-            invAmp[hi][hf][gi] = uF[hf].ScalarProd(D * vF[hi]);
+            amp[(gi << 2) + (hf << 1) + hi] = uF[hf].ScalarProd(D * vF[hi]);
          }
       }
    }
 
-   // Sum over spins
-   Complex_t ampSquared=0;
-   for (Int_t gi=0; gi < 2; gi++) {
-    for (Int_t gibar=0; gibar < 2; gibar++) {
-     for (Int_t hi=0; hi < 2; hi++) {
-      for (Int_t hibar=0; hibar < 2; hibar++) {
-       for (Int_t hf=0; hf < 2; hf++) {
-        for (Int_t hfbar=0; hfbar < 2; hfbar++) {
-           ampSquared += invAmp[hi][hf][gi] *
-               std::conj(invAmp[hibar][hfbar][gibar]) *
-                         pF->SDM()[hi][hibar] *
-                         eF->SDM()[hfbar][hf] *
-                         gI->SDM()[gi][gibar];
-        }
-       }
-      }
-     }
-    }
-   }
-
-#if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
-   {
-      std::cout << "Warning: bad PairProduction amplitudes:" << std::endl
-                << "  These guys should be all real positive:" << std::endl
-                << "    ampSquared = " << ampSquared << std::endl;
-   }
-#endif
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux factor from initial state 1/(2E)
    //    (2) rho from density of final states factor
@@ -462,9 +801,8 @@ LDouble_t TCrossSection::PairProduction(const TPhoton &gIn,
    // the momentum axis of the pair, rather than the incoming photon.
 
    LDouble_t kinFactor = 1/sqr(2*PI_*gI->Mom()[0]);
-   LDouble_t diffXsect = hbarcSqr*pow(alphaQED,3)*real(ampSquared)
-                       *kinFactor/sqr(qRecoil.InvariantSqr());
-   return diffXsect;
+   amp.SetKinFactor(hbarcSqr*pow(alphaQED,3)
+                    *kinFactor/sqr(qRecoil.InvariantSqr()));
 }
 
 LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
@@ -488,6 +826,59 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
    // depends on the internal structure of the target atom, and so is left to
    // be carried out by more specialized code.  Units are microbarns/GeV^4/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::TripletProduction");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   TripletProductionAmplitude(gIn, eIn, pOut, eOut2, eOut3, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Sum over spins
+   const TPauliMatrix *sdm[5] = {&gIn.SDM(), &eIn.SDM(), &pOut.SDM(),
+                                 &eOut2.SDM(), &eOut3.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+   if (EscalationOn())
+      Escalate(amp, sdm);
+
+   if (ValidationDue()) {
+      DIRACXX_PROFILE_SECTION("validation");
+      TAmplitudeTensor ward;
+      wardLeg = 0;
+      TripletProductionAmplitude(gIn, eIn, pOut, eOut2, eOut3, ward);
+      wardLeg = -1;
+      LDouble_t scale = gIn.Mom()[0];
+      ValidateAmplitude(amp, sdm, &ward, &scale, 1);
+   }
+
+#if DEBUGGING
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
+   {
+      TFourVectorReal mom[5] = {gIn.Mom(), eIn.Mom(), pOut.Mom(),
+                                eOut2.Mom(), eOut3.Mom()};
+      ReportDiagnostic(kDiagTripletProduction, ampSquared, mom, 5);
+   }
+#endif
+
+   LDouble_t diffXsect = amp.KinFactor() * real(ampSquared);
+   return diffXsect;
+}
+
+void TCrossSection::TripletProductionAmplitude(const TPhoton &gIn,
+                                               const TLepton &eIn,
+                                               const TLepton &pOut,
+                                               const TLepton &eOut2,
+                                               const TLepton &eOut3,
+                                               TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for triplet production, and stores
+   // them in amp together with the factor that converts |M|^2 into the
+   // differential cross section returned by TripletProduction().  The legs
+   // of amp are numbered in argument order, 0=gIn, 1=eIn, 2=pOut, 3=eOut2,
+   // 4=eOut3.  The outgoing +lepton is described by a v spinor, so its SDM
+   // is contracted with the same index order as the initial-state legs.
+   // The polarization states of the input arguments are ignored.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::TripletProductionAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TPhoton gIncoming(gIn), *g0=&gIncoming;
    TLepton eIncoming(eIn), *e0=&eIncoming;
    TLepton pOutgoing(pOut), *e1=&pOutgoing;
@@ -497,6 +888,7 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
    // Assume without checking that all leptons have the same mass;
    const LDouble_t mLepton = e0->Mass();
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the four lepton state vectors
    TDiracSpinor u0[2]; // incoming electron
    u0[0].SetStateU(e0->Mom(), +0.5);
@@ -534,12 +926,22 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
    // (diag=GD) pair of diagrams with final-state electron (swap=3) connected
    // to the initial-state electron.
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Pre-compute the electron propagators (a,b suffix for 2 diagrams in pair)
    TDiracMatrix dm;
    LDouble_t edenomCD2a = +2 * g0->Mom().ScalarProd(e0->Mom());
    LDouble_t edenomCD2b = -2 * g0->Mom().ScalarProd(e2->Mom());
    LDouble_t edenomGD2a = -2 * g0->Mom().ScalarProd(e1->Mom());
    LDouble_t edenomGD2b = -2 * g0->Mom().ScalarProd(e3->Mom());
+   if (EscalationOn()) {
+      Double_t cond = ProductCondition(g0->Mom(), e0->Mom());
+      cond = std::max(cond, ProductCondition(g0->Mom(), e1->Mom()));
+      cond = std::max(cond, ProductCondition(g0->Mom(), e2->Mom()));
+      cond = std::max(cond, ProductCondition(g0->Mom(), e3->Mom()));
+      escalationCondition = cond *
+                 std::max(RecoilCondition(e0->Mom() - e2->Mom(), mLepton),
+                          RecoilCondition(e0->Mom() - e3->Mom(), mLepton));
+   }
    TDiracMatrix epropCD2a = dm.Slash(g0->Mom() + e0->Mom()) + mLepton;
    TDiracMatrix epropCD2b = dm.Slash(e2->Mom() - g0->Mom()) + mLepton;
    TDiracMatrix epropGD2a = dm.Slash(g0->Mom() - e1->Mom()) + mLepton;
@@ -559,6 +961,7 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
    LDouble_t gpropCD3 = 1 / (e1->Mom() + e2->Mom()).InvariantSqr();
    LDouble_t gpropGD3 = 1 / (e0->Mom() - e3->Mom()).InvariantSqr();
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
    const TDiracMatrix gamma1(kDiracGamma1);
@@ -567,11 +970,11 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
    TDiracMatrix gamma[4] = {gamma0, gamma1, gamma2, gamma3};
 
    // Compute the product chains of Dirac matrices
-   Complex_t invAmp[2][2][2][2][2] = {0};
+   amp.SetLegs(5, (1 << 3) + (1 << 4));
    for (Int_t gi=0; gi < 2; gi++) {
       for (Int_t mu=0; mu < 4; mu++) {
          TDiracMatrix epsI;
-         epsI.Slash(g0->Eps(gi+1));
+         epsI.Slash(PhotonEps(g0, 0, gi+1));
          TDiracMatrix CD2;
          CD2 = gamma[mu] * epropCD2a * epsI + epsI * epropCD2b * gamma[mu];
          CD2 *= gpropCD2;
@@ -594,8 +997,8 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
             for (Int_t h1=0; h1 < 2; h1++) {
                for (Int_t h2=0; h2 < 2; h2++) {
                   for (Int_t h3=0; h3 < 2; h3++) {
-                     invAmp[h0][h1][h2][h3][gi] += 
-                           Complex_t(((mu == 0)? +1.L : -1.L) * (
+                     amp[(gi << 4) + (h0 << 3) + (h1 << 2) + (h2 << 1) + h3] +=
+                           Complex_t((LDouble_t)((mu == 0)? +1 : -1) * (
                               u3[h3].ScalarProd(gamma[mu] * v1[h1]) *
                               u2[h2].ScalarProd(CD2 * u0[h0])
                             - u2[h2].ScalarProd(gamma[mu] * v1[h1]) *
@@ -612,45 +1015,7 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
       }
    }
 
-   // Sum over spins
-   Complex_t ampSquared(0);
-   for (Int_t gi=0; gi < 2; gi++) {
-    for (Int_t gibar=0; gibar < 2; gibar++) {
-     for (Int_t h0=0; h0 < 2; ++h0) {
-      for (Int_t h0bar=0; h0bar < 2; ++h0bar) {
-       for (Int_t h1=0; h1 < 2; ++h1) {
-        for (Int_t h1bar=0; h1bar < 2; ++h1bar) {
-         for (Int_t h2=0; h2 < 2; ++h2) {
-          for (Int_t h2bar=0; h2bar < 2; ++h2bar) {
-           for (Int_t h3=0; h3 < 2; ++h3) {
-            for (Int_t h3bar=0; h3bar < 2; ++h3bar) {
-               ampSquared += invAmp[h0][h1][h2][h3][gi] *
-                   std::conj(invAmp[h0bar][h1bar][h2bar][h3bar][gibar]) *
-                             e0->SDM()[h0][h0bar] *
-                             e1->SDM()[h1][h1bar] *
-                             e2->SDM()[h2bar][h2] *
-                             e3->SDM()[h3bar][h3] *
-                             g0->SDM()[gi][gibar];
-            }
-           }
-          }
-         }
-        }
-       }
-      }
-     }
-    }
-   }
-
-#if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
-   {
-      std::cout << "Warning: bad triplets amplitude: " << std::endl
-                << "  These guys should be all real positive:" << std::endl
-                << "    ampSquared = " << ampSquared << std::endl;
-   }
-#endif
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux from initial state 1/(4 kin [p0 + E0])
    //    (2) rho from density of final states factor
@@ -664,9 +1029,8 @@ LDouble_t TCrossSection::TripletProduction(const TPhoton &gIn,
    LDouble_t fluxFactor = 4*g0->Mom()[0]*(e0->Mom().Length()+e0->Mom()[0]);
    LDouble_t rhoFactor = 1/(8*e3->Mom()[0]*(e1->Mom()+e2->Mom()).Length());
    LDouble_t piFactor = pow(2*PI_,4-9)*pow(4*PI_,3);
-   LDouble_t diffXsect = hbarcSqr * pow(alphaQED,3) * real(ampSquared)
-                        / fluxFactor * rhoFactor * piFactor;
-   return diffXsect;
+   amp.SetKinFactor(hbarcSqr * pow(alphaQED,3)
+                    / fluxFactor * rhoFactor * piFactor);
 }
 
 LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
@@ -697,6 +1061,66 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
    // the user specifies through the momenta passed in the argument objects.
    // Units are microbarns/GeV^4/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::BetheHeitlerNucleon");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   BetheHeitlerNucleonAmplitude(gIn, nIn, pOut, eOut, nOut,
+                                F1spacelike, F2spacelike,
+                                F1timelike, F2timelike, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Sum over spins
+   const TPauliMatrix *sdm[5] = {&gIn.SDM(), &nIn.SDM(), &pOut.SDM(),
+                                 &eOut.SDM(), &nOut.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+
+   if (ValidationDue()) {
+      DIRACXX_PROFILE_SECTION("validation");
+      TAmplitudeTensor ward;
+      wardLeg = 0;
+      BetheHeitlerNucleonAmplitude(gIn, nIn, pOut, eOut, nOut,
+                                   F1spacelike, F2spacelike,
+                                   F1timelike, F2timelike, ward);
+      wardLeg = -1;
+      LDouble_t scale = gIn.Mom()[0];
+      ValidateAmplitude(amp, sdm, &ward, &scale, 1);
+   }
+
+#if DEBUGGING
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
+   {
+      TFourVectorReal mom[5] = {gIn.Mom(), nIn.Mom(), pOut.Mom(),
+                                eOut.Mom(), nOut.Mom()};
+      ReportDiagnostic(kDiagBetheHeitler, ampSquared, mom, 5);
+   }
+#endif
+
+   LDouble_t diffXsect = amp.KinFactor()*real(ampSquared);
+   return diffXsect;
+}
+
+void TCrossSection::BetheHeitlerNucleonAmplitude(const TPhoton &gIn,
+                                                 const TLepton &nIn,
+                                                 const TLepton &pOut,
+                                                 const TLepton &eOut,
+                                                 const TLepton &nOut,
+                                                 LDouble_t F1spacelike,
+                                                 LDouble_t F2spacelike,
+                                                 LDouble_t F1timelike,
+                                                 LDouble_t F2timelike,
+                                                 TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for Bethe Heitler pair production
+   // off a free nucleon, and stores them in amp together with the factor
+   // that converts |M|^2 into the differential cross section returned by
+   // BetheHeitlerNucleon().  The legs of amp are numbered in argument
+   // order, 0=gIn, 1=nIn, 2=pOut, 3=eOut, 4=nOut.  The final positron is
+   // described by a v spinor, so its SDM is contracted in the same way as
+   // an initial-state leg, and only legs 3 and 4 are flagged as final.
+   // The polarization states of the input arguments are ignored.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::BetheHeitlerNucleonAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TPhoton gIncoming(gIn), *g0=&gIncoming;
    TLepton nIncoming(nIn), *n0=&nIncoming;
    TLepton pOutgoing(pOut), *e1=&pOutgoing;
@@ -706,6 +1130,7 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
    const LDouble_t mLepton = e1->Mass();
    const LDouble_t mNucleon = n0->Mass();
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the four fermion state vectors
    TDiracSpinor u0[2]; // incoming nucleon
    u0[0].SetStateU(n0->Mom(), +0.5);
@@ -738,6 +1163,7 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
    // For example, dmGD refers to the Dirac matrix product coming from the
    // (diag=GD) pair.
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Pre-compute the fermion propagators (a,b suffix for 2 diagrams in pair)
    TDiracMatrix dm;
    LDouble_t ndenomCDa = +2 * g0->Mom().ScalarProd(n0->Mom());
@@ -757,6 +1183,7 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
    LDouble_t gpropCD = 1 / (e1->Mom() + e2->Mom()).InvariantSqr();
    LDouble_t gpropGD = 1 / (n0->Mom() - n3->Mom()).InvariantSqr();
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
    const TDiracMatrix gamma1(kDiracGamma1);
@@ -803,12 +1230,11 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
                  (-sigma03 * qGD[0] + sigma13 * qGD[1] + sigma23 * qGD[2])
             };
 
-   // Compute the product chains of Dirac matrices
-   Complex_t invAmp[2][2][2][2][2] = {0};
+   amp.SetLegs(5, (1 << 3) + (1 << 4));
    for (Int_t gi=0; gi < 2; gi++) {
       for (Int_t mu=0; mu < 4; mu++) {
          TDiracMatrix epsI;
-         epsI.Slash(g0->Eps(gi+1));
+         epsI.Slash(PhotonEps(g0, 0, gi+1));
          TDiracMatrix CD;
          CD = JnucleonCD[mu] * npropCDa * epsI + epsI * npropCDb * JnucleonCD[mu];
          CD *= gpropCD;
@@ -819,8 +1245,8 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
             for (Int_t h1=0; h1 < 2; h1++) {
                for (Int_t h2=0; h2 < 2; h2++) {
                   for (Int_t h3=0; h3 < 2; h3++) {
-                     invAmp[h0][h1][h2][h3][gi] += 
-                           Complex_t(((mu == 0)? +1.L : -1.L) * (
+                     amp[(gi << 4) + (h0 << 3) + (h1 << 2) + (h2 << 1) + h3] +=
+                           Complex_t((LDouble_t)((mu == 0)? +1 : -1) * (
                               u2[h2].ScalarProd(gamma[mu] * v1[h1]) *
                               u3[h3].ScalarProd(CD * u0[h0])
                             + u3[h3].ScalarProd(JnucleonGD[mu] * u0[h0]) *
@@ -833,45 +1259,7 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
       }
    }
 
-   // Sum over spins
-   Complex_t ampSquared(0);
-   for (Int_t gi=0; gi < 2; gi++) {
-    for (Int_t gibar=0; gibar < 2; gibar++) {
-     for (Int_t h0=0; h0 < 2; ++h0) {
-      for (Int_t h0bar=0; h0bar < 2; ++h0bar) {
-       for (Int_t h1=0; h1 < 2; ++h1) {
-        for (Int_t h1bar=0; h1bar < 2; ++h1bar) {
-         for (Int_t h2=0; h2 < 2; ++h2) {
-          for (Int_t h2bar=0; h2bar < 2; ++h2bar) {
-           for (Int_t h3=0; h3 < 2; ++h3) {
-            for (Int_t h3bar=0; h3bar < 2; ++h3bar) {
-               ampSquared += invAmp[h0][h1][h2][h3][gi] *
-                   std::conj(invAmp[h0bar][h1bar][h2bar][h3bar][gibar]) *
-                             n0->SDM()[h0][h0bar] *
-                             e1->SDM()[h1][h1bar] *
-                             e2->SDM()[h2bar][h2] *
-                             n3->SDM()[h3bar][h3] *
-                             g0->SDM()[gi][gibar];
-            }
-           }
-          }
-         }
-        }
-       }
-      }
-     }
-    }
-   }
-
-#if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
-   {
-      std::cout << "Warning: bad Bethe-Heitler amplitude: " << std::endl
-                << "  These guys should be all real positive:" << std::endl
-                << "    ampSquared = " << ampSquared << std::endl;
-   }
-#endif
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux from initial state 1/(4 kin [p0 + E0])
    //    (2) rho from density of final states factor
@@ -885,9 +1273,8 @@ LDouble_t TCrossSection::BetheHeitlerNucleon(const TPhoton &gIn,
    LDouble_t fluxFactor = 4*g0->Mom()[0]*(n0->Mom().Length()+n0->Mom()[0]);
    LDouble_t rhoFactor = 1/(8*n3->Mom()[0]*(e1->Mom()+e2->Mom()).Length());
    LDouble_t piFactor = pow(2*PI_,4-9)*pow(4*PI_,3);
-   LDouble_t diffXsect = hbarcSqr * pow(alphaQED,3) * real(ampSquared)
-                        / fluxFactor * rhoFactor * piFactor;
-   return diffXsect;
+   amp.SetKinFactor(hbarcSqr * pow(alphaQED,3)
+                    / fluxFactor * rhoFactor * piFactor);
 }
 
 LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
@@ -911,6 +1298,8 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
    // depends on the internal structure of the target atom, and so is left to
    // be carried out by more specialized code.  Units are microbarns/GeV^4/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::eeBremsstrahlung");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TLepton eIncoming0(eIn0), *e0=&eIncoming0;
    TLepton eIncoming1(eIn1), *e1=&eIncoming1;
    TLepton eOutgoing2(eOut2), *e2=&eOutgoing2;
@@ -920,6 +1309,7 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
    // The two leptons must be identical, not checked
    const LDouble_t mLepton=e0->Mass();
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the four lepton state vectors
    TDiracSpinor u0[2];
    u0[0].SetStateU(e0->Mom(), +0.5);
@@ -956,6 +1346,7 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
    // leg (leg=1) containing the initial-state electron eIn1, with radiation
    // from the right-hand leg connecting eIn1 to eOut3 (diag=B).
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Pre-compute the electron propagators
    TDiracMatrix dm;
    LDouble_t edenomA1(-2 * g0->Mom().ScalarProd(e0->Mom()));
@@ -981,6 +1372,7 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
    LDouble_t gpropC = 1 / (e1->Mom() - e2->Mom()).InvariantSqr();
    LDouble_t gpropD = 1 / (e0->Mom() - e3->Mom()).InvariantSqr();
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
    const TDiracMatrix gamma1(kDiracGamma1);
@@ -988,12 +1380,22 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
    const TDiracMatrix gamma3(kDiracGamma3);
    TDiracMatrix gamma[4] = {gamma0, gamma1, gamma2, gamma3};
 
-   // Compute the product chains of Dirac matrices
-   Complex_t invAmp[2][2][2][2][2] = {0};
-   for (Int_t gf=0; gf < 2; gf++) {
+   // Compute the product chains of Dirac matrices, and on the calls
+   // sampled for validation, a second time with the photon polarization
+   // replaced by its momentum for the Ward identity check
+   Bool_t validate = ValidationDue();
+   Complex_t invAmp[2][2][2][2][2];
+   Complex_t wardAmp[2][2][2][2][2];
+   for (Int_t pass=0; pass < (validate? 2 : 1); pass++) {
+    Complex_t (*chain)[2][2][2][2] = (pass == 0)? invAmp : wardAmp;
+    Complex_t *flat = &chain[0][0][0][0][0];
+    for (Int_t i=0; i < 32; i++)
+       flat[i] = 0;
+    wardLeg = (pass == 0)? -1 : 4;
+    for (Int_t gf=0; gf < 2; gf++) {
       for (Int_t mu=0; mu < 4; mu++) {
          TDiracMatrix epsF;
-         epsF.Slash(g0->EpsStar(gf+1));
+         epsF.Slash(PhotonEpsStar(g0, 4, gf+1));
          TDiracMatrix A;
          A = gamma[mu] * epropA1 * epsF + epsF * epropA2 * gamma[mu];
          A *= gpropA;
@@ -1010,8 +1412,8 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
             for (Int_t h1=0; h1 < 2; h1++) {
                for (Int_t h2=0; h2 < 2; h2++) {
                   for (Int_t h3=0; h3 < 2; h3++) {
-                     invAmp[h0][h1][h2][h3][gf] +=
-                           Complex_t(((mu == 0)? +1.L : -1.L) * (
+                     chain[h0][h1][h2][h3][gf] +=
+                           Complex_t((LDouble_t)((mu == 0)? +1 : -1) * (
                               u3[h3].ScalarProd(gamma[mu] * u1[h1]) *
                               u2[h2].ScalarProd(A * u0[h0])
                             + u2[h2].ScalarProd(gamma[mu] * u0[h0]) *
@@ -1026,8 +1428,11 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
             }
          }
       }
+    }
    }
+   wardLeg = -1;
 
+   DIRACXX_PROFILE_SECTION("spin sums");
    // Sum over spins
    Complex_t ampSquared(0);
    for (Int_t gf=0; gf < 2; gf++) {
@@ -1058,15 +1463,31 @@ LDouble_t TCrossSection::eeBremsstrahlung(const TLepton &eIn0,
     }
    }
 
+   if (validate) {
+      DIRACXX_PROFILE_SECTION("validation");
+      // legs 0=eIn0, 1=eIn1, 2=eOut2, 3=eOut3, 4=gOut, as in the spin sum
+      TAmplitudeTensor amp(5, (1 << 2) + (1 << 3) + (1 << 4));
+      TAmplitudeTensor ward(5, (1 << 2) + (1 << 3) + (1 << 4));
+      for (Int_t i=0; i < 32; i++) {
+         amp[i] = invAmp[i>>4][(i>>3)&1][(i>>2)&1][(i>>1)&1][i&1];
+         ward[i] = wardAmp[i>>4][(i>>3)&1][(i>>2)&1][(i>>1)&1][i&1];
+      }
+      const TPauliMatrix *sdm[5] = {&e0->SDM(), &e1->SDM(), &e2->SDM(),
+                                    &e3->SDM(), &g0->SDM()};
+      LDouble_t scale = gOut.Mom()[0];
+      ValidateAmplitude(amp, sdm, &ward, &scale, 1);
+   }
+
 #if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
    {
-      std::cout << "Warning: bad eeBremsstrahlung amplitude: " << std::endl
-                << "  These guys should all be real positive: " << std::endl
-                << "    ampSquared = " << ampSquared << std::endl;
+      TFourVectorReal mom[5] = {eIn0.Mom(), eIn1.Mom(), eOut2.Mom(),
+                                eOut3.Mom(), gOut.Mom()};
+      ReportDiagnostic(kDiagEEBremsstrahlung, ampSquared, mom, 5);
    }
 #endif
 
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux factor from initial state 1/(4 E0 E1)
    //    (2) rho from density of final states factor
@@ -1110,6 +1531,53 @@ LDouble_t TCrossSection::ePairProduction(const TLepton &eIn,
    // depends on the crystal structure of the target, and so is left to
    // be carried out by more specialized code. Units are microbarns/GeV^7/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::ePairProduction");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   ePairProductionAmplitude(eIn, eOut, lpOut, lnOut, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Sum over spins
+   const TPauliMatrix *sdm[4] = {&eIn.SDM(), &eOut.SDM(),
+                                 &lpOut.SDM(), &lnOut.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+
+   if (ValidationDue()) {
+      // there is no external photon, so no Ward identity to check
+      DIRACXX_PROFILE_SECTION("validation");
+      ValidateAmplitude(amp, sdm, 0, 0, 0);
+   }
+
+#if DEBUGGING
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
+   {
+      TFourVectorReal mom[4] = {eIn.Mom(), eOut.Mom(),
+                                lpOut.Mom(), lnOut.Mom()};
+      ReportDiagnostic(kDiagEPairProduction, ampSquared, mom, 4);
+   }
+#endif
+
+   LDouble_t diffXsect = amp.KinFactor()*real(ampSquared);
+   return diffXsect;
+}
+
+void TCrossSection::ePairProductionAmplitude(const TLepton &eIn,
+                                             const TLepton &eOut,
+                                             const TLepton &lpOut,
+                                             const TLepton &lnOut,
+                                             TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for pair production by an electron,
+   // and stores them in amp together with the factor that converts |M|^2
+   // into the differential cross section returned by ePairProduction().
+   // The legs of amp are numbered in argument order, 0=eIn, 1=eOut,
+   // 2=lpOut, 3=lnOut.  The final +lepton is described by a v spinor, so
+   // its SDM is contracted in the same way as an initial-state leg, and
+   // only legs 1 and 3 are flagged as final.  The polarization states of
+   // the input arguments are ignored.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::ePairProductionAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TLepton eIncoming(eIn),  *eI=&eIncoming;
    TLepton eOutgoing(eOut), *eF=&eOutgoing;
 
@@ -1118,6 +1586,7 @@ LDouble_t TCrossSection::ePairProduction(const TLepton &eIn,
    TLepton lpOutgoing(lpOut), *lpF=&lpOutgoing;
    TLepton lnOutgoing(lnOut), *lnF=&lnOutgoing;
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the lepton state vectors
    TDiracSpinor uI[2];
    uI[0].SetStateU(eI->Mom(), +0.5);
@@ -1137,6 +1606,7 @@ LDouble_t TCrossSection::ePairProduction(const TLepton &eIn,
 
    TDiracMatrix dm;
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Obtain the electron propagators for the four basic diagrams
    TFourVectorReal qElectron(eI->Mom() - eF->Mom());
    TFourVectorReal qPair(lnF->Mom() + lpF->Mom());
@@ -1175,21 +1645,22 @@ LDouble_t TCrossSection::ePairProduction(const TLepton &eIn,
    ePropagator7 /= edenom7;
    ePropagator8 /= edenom8;
 
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
    const TDiracMatrix gamma1(kDiracGamma1);
    const TDiracMatrix gamma2(kDiracGamma2);
    const TDiracMatrix gamma3(kDiracGamma3);
    TDiracMatrix gamma[4] = {gamma0, gamma1, gamma2, gamma3};
-   Complex_t invAmp[2][2][2][2];
+   amp.SetLegs(4, (1 << 1) + (1 << 3));
    for (Int_t hi=0; hi < 2; hi++) {
       for (Int_t hf=0; hf < 2; hf++) {
          for (Int_t li=0; li < 2; li++) {
             for (Int_t lf=0; lf < 2; lf++) {
-               invAmp[hi][hf][li][lf] = 0;
+               Complex_t &a = amp[(hi << 3) + (hf << 2) + (li << 1) + lf];
                for (Int_t mu=0; mu < 4; mu++) {
-                  invAmp[hi][hf][li][lf] += 
-                    Complex_t(((mu == 0)? +1.L : -1.L) * (
+                  a += 
+                    Complex_t((LDouble_t)((mu == 0)? +1 : -1) * (
                         uF[hf].ScalarProd(gamma[mu] * uI[hi]) *
                         ( ulF[lf].ScalarProd(gamma0 * ePropagator1 *
                                              gamma[mu] * vlF[li])
@@ -1221,40 +1692,7 @@ LDouble_t TCrossSection::ePairProduction(const TLepton &eIn,
       }
    }
 
-   // Sum over spins
-   Complex_t ampSquared=0;
-   for (Int_t li=0; li < 2; li++) {
-    for (Int_t libar=0; libar < 2; libar++) {
-     for (Int_t lf=0; lf < 2; lf++) {
-      for (Int_t lfbar=0; lfbar < 2; lfbar++) {
-       for (Int_t hi=0; hi < 2; hi++) {
-        for (Int_t hibar=0; hibar < 2; hibar++) {
-         for (Int_t hf=0; hf < 2; hf++) {
-          for (Int_t hfbar=0; hfbar < 2; hfbar++) {
-             ampSquared += invAmp[hi][hf][li][lf] *
-                 std::conj(invAmp[hibar][hfbar][libar][lfbar]) *
-                           eI->SDM()[hi][hibar] *
-                           eF->SDM()[hfbar][hf] *
-                           lpF->SDM()[li][libar] *
-                           lnF->SDM()[lfbar][lf];
-          }
-         }
-        }
-       }
-      }
-     }
-    }
-   }
-
-#if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
-   {
-      std::cout << "Warning: bad PairProduction amplitudes:" << std::endl
-                << "  These guys should be all real positive:" << std::endl
-                << "    ampSquared = " << ampSquared << std::endl;
-   }
-#endif
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux factor from initial state 1/(2E)
    //    (2) rho from density of final states factor
@@ -1271,9 +1709,8 @@ LDouble_t TCrossSection::ePairProduction(const TLepton &eIn,
 
    LDouble_t kinFactor = 1/pow(2*PI_,4);
    kinFactor /= eIn.Mom()[0] * eOut.Mom()[0] * qPair.Length();
-   LDouble_t diffXsect = hbarcSqr*pow(alphaQED,4)*real(ampSquared)
-                       * kinFactor/sqr(qTarget.InvariantSqr());
-   return diffXsect;
+   amp.SetKinFactor(hbarcSqr*pow(alphaQED,4)
+                    *kinFactor/sqr(qTarget.InvariantSqr()));
 }
 
 LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
@@ -1297,6 +1734,56 @@ LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
    // depends on the atom in which the target electron is bound, and so is
    // left to be applied by the user. Units are microbarns/GeV^7/r.
 
+   DIRACXX_PROFILE_SCOPE("TCrossSection::eTripletProduction");
+   DIRACXX_PROFILE_SECTION("amplitudes");
+   TAmplitudeTensor amp;
+   eTripletProductionAmplitude(eIn, eOut, lpOut, lnOut, teIn, teOut, amp);
+
+   DIRACXX_PROFILE_SECTION("spin sums");
+   // Sum over spins
+   const TPauliMatrix *sdm[6] = {&eIn.SDM(), &eOut.SDM(), &lpOut.SDM(),
+                                 &lnOut.SDM(), &teIn.SDM(), &teOut.SDM()};
+   Complex_t ampSquared = amp.AmpSquared(sdm);
+
+   if (ValidationDue()) {
+      // there is no external photon, so no Ward identity to check
+      DIRACXX_PROFILE_SECTION("validation");
+      ValidateAmplitude(amp, sdm, 0, 0, 0);
+   }
+
+#if DEBUGGING
+   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / (LDouble_t)1e8))
+   {
+      TFourVectorReal mom[6] = {eIn.Mom(), eOut.Mom(), lpOut.Mom(),
+                                lnOut.Mom(), teIn.Mom(), teOut.Mom()};
+      ReportDiagnostic(kDiagETripletProduction, ampSquared, mom, 6);
+   }
+#endif
+
+   LDouble_t diffXsect = amp.KinFactor()*real(ampSquared);
+   return diffXsect;
+}
+
+void TCrossSection::eTripletProductionAmplitude(const TLepton &eIn,
+                                                const TLepton &eOut,
+                                                const TLepton &lpOut,
+                                                const TLepton &lnOut,
+                                                const TLepton &teIn,
+                                                const TLepton &teOut,
+                                                TAmplitudeTensor &amp)
+{
+   // Computes the helicity amplitudes for pair production by an electron
+   // off a target electron, and stores them in amp together with the
+   // factor that converts |M|^2 into the differential cross section
+   // returned by eTripletProduction().  The legs of amp are numbered in
+   // argument order, 0=eIn, 1=eOut, 2=lpOut, 3=lnOut, 4=teIn, 5=teOut.
+   // The final positron is described by a v spinor, so its SDM is
+   // contracted in the same way as an initial-state leg, and only legs
+   // 1, 3 and 5 are flagged as final.  The polarization states of the
+   // input arguments are ignored.
+
+   DIRACXX_PROFILE_SCOPE("TCrossSection::eTripletProductionAmplitude");
+   DIRACXX_PROFILE_SECTION("kinematics");
    TLepton eIncoming(eIn),  *eI=&eIncoming;
    TLepton eOutgoing(eOut), *eF=&eOutgoing;
 
@@ -1308,6 +1795,7 @@ LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
    TLepton teIncoming(teIn), *teI=&teIncoming;
    TLepton teOutgoing(teOut), *teF=&teOutgoing;
 
+   DIRACXX_PROFILE_SECTION("spinors");
    // Obtain the lepton state vectors
    TDiracSpinor uI[2];
    uI[0].SetStateU(eI->Mom(), +0.5);
@@ -1333,6 +1821,7 @@ LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
 
    TDiracMatrix dm;
 
+   DIRACXX_PROFILE_SECTION("propagators");
    // Obtain the electron propagators for the six basic diagrams,
    // each one repeated for all permutations of outgoing electrons.
    int nperms = (mLepton == mElectron)? 6 : 2;
@@ -1371,27 +1860,29 @@ LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
       ePropagator[5][p] /= qElectron2[p] - 2 * qElectron[p].ScalarProd(teFs[p]->Mom());
    }
  
+   DIRACXX_PROFILE_SECTION("amplitude products");
    // Evaluate the leading order Feynman amplitude
    const TDiracMatrix gamma0(kDiracGamma0);
    const TDiracMatrix gamma1(kDiracGamma1);
    const TDiracMatrix gamma2(kDiracGamma2);
    const TDiracMatrix gamma3(kDiracGamma3);
    TDiracMatrix gamma[4] = {gamma0, gamma1, gamma2, gamma3};
-   Complex_t invAmp[2][2][2][2][2][2];
+   amp.SetLegs(6, (1 << 1) + (1 << 3) + (1 << 5));
    for (Int_t hi=0; hi < 2; hi++) {
      for (Int_t hf=0; hf < 2; hf++) {
        for (Int_t li=0; li < 2; li++) {
          for (Int_t lf=0; lf < 2; lf++) {
            for (Int_t ti=0; ti < 2; ti++) {
              for (Int_t tf=0; tf < 2; tf++) {
-               invAmp[hi][hf][li][lf][ti][tf] = 0;
+               Complex_t &a = amp[(hi << 5) + (hf << 4) + (li << 3) +
+                                  (lf << 2) + (ti << 1) + tf];
                for (Int_t mu=0; mu < 4; mu++) {
                  for (Int_t nu=0; nu < 4; nu++) {
                    for (Int_t p=0; p < nperms; ++p) {
-                     invAmp[hi][hf][li][lf][ti][tf] += 
-                      Complex_t(((mu == 0)? +1.L : -1.L) *
-                                ((nu == 0)? +1.L : -1.L) *
-                      permorder[p] * (
+                     a +=
+                      Complex_t((LDouble_t)(((mu == 0)? +1 : -1) *
+                                            ((nu == 0)? +1 : -1) *
+                                            permorder[p]) * (
                         uFs[p][hf].ScalarProd(gamma[mu] * uI[hi]) *
                         utFs[p][tf].ScalarProd(gamma[nu] * utI[ti]) *
                         ( ulFs[p][lf].ScalarProd(gamma[nu] * ePropagator[0][p] *
@@ -1424,50 +1915,7 @@ LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
      }
    }
 
-   // Sum over spins
-   Complex_t ampSquared=0;
-   for (Int_t li=0; li < 2; li++) {
-    for (Int_t libar=0; libar < 2; libar++) {
-     for (Int_t lf=0; lf < 2; lf++) {
-      for (Int_t lfbar=0; lfbar < 2; lfbar++) {
-       for (Int_t hi=0; hi < 2; hi++) {
-        for (Int_t hibar=0; hibar < 2; hibar++) {
-         for (Int_t hf=0; hf < 2; hf++) {
-          for (Int_t hfbar=0; hfbar < 2; hfbar++) {
-           for (Int_t ti=0; ti < 2; ti++) {
-            for (Int_t tibar=0; tibar < 2; tibar++) {
-             for (Int_t tf=0; tf < 2; tf++) {
-              for (Int_t tfbar=0; tfbar < 2; tfbar++) {
-                ampSquared += invAmp[hi][hf][li][lf][ti][tf] *
-                 std::conj(invAmp[hibar][hfbar][libar][lfbar][tibar][tfbar]) *
-                           eI->SDM()[hi][hibar] *
-                           eF->SDM()[hfbar][hf] *
-                           lpF->SDM()[li][libar] *
-                           lnF->SDM()[lfbar][lf] *
-                           teI->SDM()[ti][tibar] *
-                           teF->SDM()[tfbar][tf];
-              }
-             }
-            }
-           }
-          }
-         }
-        }
-       }
-      }
-     }
-    }
-   }
-
-#if DEBUGGING
-   if (real(ampSquared) < 0 || fabs(ampSquared.imag()) > fabs(ampSquared / 1e8L))
-   {
-      std::cout << "Warning: bad PairProduction amplitudes:" << std::endl
-                << "  These guys should be all real positive:" << std::endl
-                << "    ampSquared = " << ampSquared << std::endl;
-   }
-#endif
-
+   DIRACXX_PROFILE_SECTION("kinematic factor");
    // Obtain the kinematical factors:
    //    (1) 1/flux factor from initial state 1/(4mE)
    //    (2) rho from density of final states factor
@@ -1484,9 +1932,261 @@ LDouble_t TCrossSection::eTripletProduction(const TLepton &eIn,
    LDouble_t kinFactor = 1/pow(2*PI_,4);
    kinFactor /= 4 * mElectron * teOut.Mom()[0];
    kinFactor /= eIn.Mom()[0] * eOut.Mom()[0] * qPair[0].Length();
-   LDouble_t diffXsect = hbarcSqr*pow(alphaQED,4)*real(ampSquared)
-                       * kinFactor;
-   return diffXsect;
+   amp.SetKinFactor(hbarcSqr*pow(alphaQED,4)*kinFactor);
+}
+
+void TCrossSection::SetValidation(Double_t rate, Double_t tolerance)
+{
+   // Sets the fraction of calls to each of the cross section methods on
+   // each thread for which the amplitudes are validated, and the relative
+   // tolerance of the checks.  The Ward identity check evaluates the
+   // amplitudes once more for each external photon, so the cost is small
+   // at the default rate of 1e-4.  A rate of zero turns the validation
+   // off.  ePairProduction and eTripletProduction have no external photon,
+   // so only the hermiticity and positivity checks are made for them.
+
+   validationStride = (rate > 0)? (UInt_t)(1/rate + 0.5) : 0;
+   if (rate > 0 && validationStride == 0)
+      validationStride = 1;
+   validationTolerance = tolerance;
+}
+
+ULong64_t TCrossSection::GetValidationCount(EValidation type)
+{
+   // Returns the number of checks (kValidationChecks) or violations of
+   // a given type counted since the last ResetValidation.
+
+   if (type < 0 || type >= kValidationTypes)
+      return 0;
+   return validationCount[type];
+}
+
+void TCrossSection::ResetValidation()
+{
+   // Zeros all of the validation counters.
+
+   for (Int_t i=0; i < kValidationTypes; i++)
+      validationCount[i] = 0;
+}
+
+void TCrossSection::PrintValidation()
+{
+   // Prints a summary of the amplitude validation counters.
+
+   std::cout << "TCrossSection amplitude validation: "
+             << validationCount[kValidationChecks] << " checks, "
+             << validationCount[kValidationWard] << " Ward identity, "
+             << validationCount[kValidationHermiticity] << " hermiticity, "
+             << validationCount[kValidationPositivity] << " positivity"
+             << " violations" << std::endl;
+}
+
+void TCrossSection::SetDiagnosticPrintLimit(Int_t limit)
+{
+   // Sets the number of warnings of each type that are printed as soon
+   // as they occur, summed over all threads.  All warnings are counted,
+   // whether printed or not.  The default is 1.
+
+   diagnosticPrintLimit = limit;
+}
+
+ULong64_t TCrossSection::GetDiagnosticCount(EDiagnostic type)
+{
+   // Returns the number of failed checks of a given type, summed over
+   // all threads, since the last ResetDiagnostics.
+
+   if (type < 0 || type >= kDiagnosticTypes)
+      return 0;
+   ULong64_t count = 0;
+   std::lock_guard<std::mutex> guard(diagnosticLock);
+   for (UInt_t b=0; b < diagnosticBlocks.size(); b++)
+      count += diagnosticBlocks[b]->count[type];
+   return count;
+}
+
+void TCrossSection::ResetDiagnostics()
+{
+   // Zeros all of the diagnostic counters and exemplars.  This should
+   // only be called when no other threads are computing cross sections.
+
+   std::lock_guard<std::mutex> guard(diagnosticLock);
+   for (UInt_t b=0; b < diagnosticBlocks.size(); b++) {
+      for (Int_t i=0; i < kDiagnosticTypes; i++) {
+         diagnosticBlocks[b]->count[i] = 0;
+         diagnosticBlocks[b]->nexemplar[i] = 0;
+      }
+      for (Int_t i=0; i < kEscalationTypes; i++)
+         diagnosticBlocks[b]->escalation[i] = 0;
+   }
+   for (Int_t i=0; i < kDiagnosticTypes; i++)
+      diagnosticPrinted[i] = 0;
+}
+
+void TCrossSection::PrintDiagnostics(Int_t maxExemplars)
+{
+   // Prints the number of failed checks of each type, summed over all
+   // threads, together with up to maxExemplars of the inputs for which
+   // they failed, listed as the value of |M|^2 followed by the four-
+   // momenta of the external legs in argument order.  In the adaptive
+   // precision mode the escalation counts are printed first.
+
+   if (escalationTolerance > 0) {
+      std::cout << "TCrossSection adaptive precision: "
+                << GetEscalationCount(kEscalationFlagged) << " of "
+                << GetEscalationCount(kEscalationChecks)
+                << " amplitude sets flagged for escalation" << std::endl;
+   }
+
+#if DEBUGGING
+   std::lock_guard<std::mutex> guard(diagnosticLock);
+   std::cout << "TCrossSection diagnostics from "
+             << diagnosticBlocks.size() << " thread(s):" << std::endl;
+   for (Int_t i=0; i < kDiagnosticTypes; i++) {
+      ULong64_t count = 0;
+      for (UInt_t b=0; b < diagnosticBlocks.size(); b++)
+         count += diagnosticBlocks[b]->count[i];
+      std::cout << "  " << diagnosticName[i] << ": " << count
+                << " bad amplitudes" << std::endl;
+      Int_t shown = 0;
+      for (UInt_t b=0; b < diagnosticBlocks.size(); b++) {
+         DiagnosticBlock *block = diagnosticBlocks[b].get();
+         Int_t n = block->nexemplar[i].load(std::memory_order_acquire);
+         for (Int_t e=0; e < n && shown < maxExemplars; e++, shown++) {
+            DiagnosticExemplar &ex = block->exemplar[i][e];
+            std::cout << "    ampSquared = " << ex.ampSquared
+                      << " at";
+            for (Int_t m=0; m < ex.nmom; m++) {
+               std::cout << " (" << ex.mom[m][0] << "," << ex.mom[m][1]
+                         << "," << ex.mom[m][2] << "," << ex.mom[m][3]
+                         << ")";
+            }
+            std::cout << std::endl;
+         }
+      }
+   }
+#else
+   std::cout << "TCrossSection diagnostics were compiled out"
+             << " (DEBUGGING=0)" << std::endl;
+#endif
+}
+
+void TCrossSection::SetEscalation(Double_t tolerance)
+{
+   // Turns on the adaptive precision mode, in which the Compton,
+   // Bremsstrahlung, PairProduction and TripletProduction methods estimate
+   // the relative rounding error of each |M|^2 they compute, and count
+   // the amplitude sets whose estimate exceeds tolerance as flagged for
+   // escalation, see Escalate.  The counts are kept with the diagnostics
+   // and read back with GetEscalationCount.  A tolerance of zero turns
+   // the mode off, which is the default.
+
+   escalationTolerance = (tolerance > 0)? tolerance : 0;
+}
+
+Double_t TCrossSection::RoundingError(const TAmplitudeTensor &amp,
+                                      const TPauliMatrix *const *sdm)
+{
+   // Returns an estimate of the relative rounding error of |M|^2 obtained
+   // by contracting amp with sdm, using the condition recorded by the
+   // last call to one of the amplitude methods listed in SetEscalation on
+   // this thread, which is then cleared.  The factor of 32 is calibrated
+   // so that the estimate bounds the error of the double build measured
+   // against the quad precision build by precision.cxx, at all of the
+   // points of its test sample.  A vanishing |M|^2 is given an infinite
+   // error, so that the points where the kinematics could not be solved
+   // are escalated.
+
+   LDouble_t terms = 0;
+   for (Int_t i=0; i < amp.Size(); i++)
+      terms += std::norm(amp[i]);
+   for (Int_t leg=0; leg < amp.Legs(); leg++) {
+      if (sdm[leg]) {
+         const TPauliMatrix &rho = *sdm[leg];
+         terms *= std::max(abs(rho[0][0]) + abs(rho[0][1]),
+                           abs(rho[1][0]) + abs(rho[1][1]));
+      }
+   }
+   Double_t condition = escalationCondition;
+   escalationCondition = 1;
+   LDouble_t ampSquared = fabs(amp.AmpSquared(sdm));
+   if (!(ampSquared > 0))
+      return 1/0.;
+   return 32 * roundingUnit * condition * (Double_t)(terms / ampSquared);
+}
+
+Bool_t TCrossSection::Escalate(const TAmplitudeTensor &amp,
+                               const TPauliMatrix *const *sdm)
+{
+   // Returns true if the rounding error of |M|^2 estimated by RoundingError
+   // exceeds the tolerance set by SetEscalation, in which case the result
+   // should be recomputed in a build of higher precision.  The checks and
+   // the events flagged are counted in the diagnostic block of the thread,
+   // and the result is also returned by Escalated until the next call.
+
+   DiagnosticBlock *block = ThreadDiagnostics();
+   CountDiagnostic(block->escalation[kEscalationChecks]);
+   Double_t tol = escalationTolerance.load(std::memory_order_relaxed);
+   escalationFlag = !(RoundingError(amp, sdm) <= tol);
+   if (escalationFlag)
+      CountDiagnostic(block->escalation[kEscalationFlagged]);
+   return escalationFlag;
+}
+
+Bool_t TCrossSection::Escalated()
+{
+   // Returns the result of the last call to Escalate on this thread, so
+   // that the caller of one of the cross section methods can tell if the
+   // value it returned is to be recomputed in a higher precision build.
+
+   return escalationFlag;
+}
+
+ULong64_t TCrossSection::GetEscalationCount(EEscalation type)
+{
+   // Returns the number of amplitude sets checked (kEscalationChecks) or
+   // flagged for escalation (kEscalationFlagged), summed over all threads,
+   // since the last ResetDiagnostics.
+
+   if (type < 0 || type >= kEscalationTypes)
+      return 0;
+   ULong64_t count = 0;
+   std::lock_guard<std::mutex> guard(diagnosticLock);
+   for (UInt_t b=0; b < diagnosticBlocks.size(); b++)
+      count += diagnosticBlocks[b]->escalation[type];
+   return count;
+}
+
+void TCrossSection::SetProfiling(Bool_t enable, Bool_t printAtExit)
+{
+   // Switches the hot-path timers on or off for all threads.  They are
+   // only present in code compiled with -DDIRACXX_PROFILE, which includes
+   // this class and any of the generator macros built that way.  If
+   // printAtExit is set, PrintProfile is called when the program exits.
+
+#if !defined DIRACXX_PROFILE
+   if (enable) {
+      std::cout << "TCrossSection::SetProfiling - warning: "
+                << "TCrossSection was compiled without -DDIRACXX_PROFILE, "
+                << "only the scopes in code compiled with it are timed"
+                << std::endl;
+   }
+#endif
+   Profiler_enable(enable, printAtExit);
+}
+
+void TCrossSection::PrintProfile()
+{
+   // Prints the times spent in each timed scope and section, merged
+   // over all threads, as a tree of call paths.
+
+   Profiler_print(std::cout);
+}
+
+void TCrossSection::ResetProfile()
+{
+   // Zeros the hot-path timers of all threads.
+
+   Profiler_reset();
 }
 
 void TCrossSection::Streamer(TBuffer &buf)
@@ -14,21 +14,63 @@
 class TPhoton;
 class TLepton;
 class TThreeVectorReal;
+class TPauliMatrix;
+class TAmplitudeTensor;
 
 class TCrossSection {
 
 public:
+   enum EValidation {
+      kValidationChecks = 0,       // number of amplitude sets checked
+      kValidationWard = 1,         // Ward identity violations
+      kValidationHermiticity = 2,  // non-hermetian density matrices
+      kValidationPositivity = 3,   // negative |M|^2 or density matrices
+      kValidationTypes = 4
+   };
+
+   enum EDiagnostic {
+      kDiagBremsstrahlung = 0,     // bad |M|^2 in Bremsstrahlung
+      kDiagPairProduction = 1,     // bad |M|^2 in PairProduction
+      kDiagTripletProduction = 2,  // bad |M|^2 in TripletProduction
+      kDiagBetheHeitler = 3,       // bad |M|^2 in BetheHeitlerNucleon
+      kDiagEEBremsstrahlung = 4,   // bad |M|^2 in eeBremsstrahlung
+      kDiagEPairProduction = 5,    // bad |M|^2 in ePairProduction
+      kDiagETripletProduction = 6, // bad |M|^2 in eTripletProduction
+      kDiagnosticTypes = 7
+   };
+
+   enum EEscalation {
+      kEscalationChecks = 0,       // amplitude sets checked for rounding
+      kEscalationFlagged = 1,      // of those, to be recomputed
+      kEscalationTypes = 2
+   };
+
    virtual ~TCrossSection() { }
 
    static LDouble_t Compton(const TPhoton &gIn, const TLepton &eIn,
                             const TPhoton &gOut, const TLepton &eOut);
+   static void ComptonAmplitude(const TPhoton &gIn, const TLepton &eIn,
+                                const TPhoton &gOut, const TLepton &eOut,
+                                TAmplitudeTensor &amp);
    static LDouble_t Bremsstrahlung(const TLepton &eIn, const TLepton &eOut,
                                    const TPhoton &gOut);
+   static void BremsstrahlungAmplitude(const TLepton &eIn, const TLepton &eOut,
+                                       const TPhoton &gOut,
+                                       TAmplitudeTensor &amp);
    static LDouble_t PairProduction(const TPhoton &gIn,
                                    const TLepton &eOut, const TLepton &pOut);
+   static void PairProductionAmplitude(const TPhoton &gIn,
+                                       const TLepton &eOut, const TLepton &pOut,
+                                       TAmplitudeTensor &amp);
    static LDouble_t TripletProduction(const TPhoton &gIn, const TLepton &eIn,
                                       const TLepton &pOut, const TLepton &eOut2,
                                       const TLepton &eOut3);
+   static void TripletProductionAmplitude(const TPhoton &gIn,
+                                          const TLepton &eIn,
+                                          const TLepton &pOut,
+                                          const TLepton &eOut2,
+                                          const TLepton &eOut3,
+                                          TAmplitudeTensor &amp);
    static LDouble_t BetheHeitlerNucleon(const TPhoton &gIn,
                                         const TLepton &nIn,
                                         const TLepton &pOut,
@@ -38,6 +80,16 @@ public:
                                         LDouble_t F2spacelike,
                                         LDouble_t F1timelike,
                                         LDouble_t F2timelike);
+   static void BetheHeitlerNucleonAmplitude(const TPhoton &gIn,
+                                            const TLepton &nIn,
+                                            const TLepton &pOut,
+                                            const TLepton &eOut,
+                                            const TLepton &nOut,
+                                            LDouble_t F1spacelike,
+                                            LDouble_t F2spacelike,
+                                            LDouble_t F1timelike,
+                                            LDouble_t F2timelike,
+                                            TAmplitudeTensor &amp);
    static LDouble_t eeBremsstrahlung(const TLepton &eIn0,
                                      const TLepton &eIn1,
                                      const TLepton &eOut2, 
@@ -47,12 +99,46 @@ public:
                                     const TLepton &eOut,
                                     const TLepton &lpOut,
                                     const TLepton &lnOut);
+   static void ePairProductionAmplitude(const TLepton &eIn,
+                                        const TLepton &eOut,
+                                        const TLepton &lpOut,
+                                        const TLepton &lnOut,
+                                        TAmplitudeTensor &amp);
    static LDouble_t eTripletProduction(const TLepton &eIn,
                                        const TLepton &eOut,
                                        const TLepton &lpOut,
                                        const TLepton &lnOut,
                                        const TLepton &teIn,
                                        const TLepton &teOut);
+   static void eTripletProductionAmplitude(const TLepton &eIn,
+                                           const TLepton &eOut,
+                                           const TLepton &lpOut,
+                                           const TLepton &lnOut,
+                                           const TLepton &teIn,
+                                           const TLepton &teOut,
+                                           TAmplitudeTensor &amp);
+
+   static void SetValidation(Double_t rate, Double_t tolerance=1e-6);
+   static ULong64_t GetValidationCount(EValidation type);
+   static void ResetValidation();
+   static void PrintValidation();
+
+   static void SetDiagnosticPrintLimit(Int_t limit);
+   static ULong64_t GetDiagnosticCount(EDiagnostic type);
+   static void ResetDiagnostics();
+   static void PrintDiagnostics(Int_t maxExemplars=1);
+
+   static void SetEscalation(Double_t tolerance);
+   static Double_t RoundingError(const TAmplitudeTensor &amp,
+                                 const TPauliMatrix *const *sdm);
+   static Bool_t Escalate(const TAmplitudeTensor &amp,
+                          const TPauliMatrix *const *sdm);
+   static Bool_t Escalated();
+   static ULong64_t GetEscalationCount(EEscalation type);
+
+   static void SetProfiling(Bool_t enable, Bool_t printAtExit=true);
+   static void PrintProfile();
+   static void ResetProfile();
 
    void Print(Option_t *option="");
 
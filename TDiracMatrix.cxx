@@ -174,7 +174,7 @@ TDiracMatrix::TDiracMatrix(const EDiracIndex i, const EDiracIndex j)
    const Complex_t i_(0,1);
    const TDiracMatrix a(i),b(j);
    *this = a*b - b*a;
-   *this *= i_/2.L;
+   *this *= i_/(LDouble_t)2;
 }
 
 TDiracMatrix &TDiracMatrix::Transpose()
@@ -196,7 +196,7 @@ Complex_t TDiracMatrix::Determ() const
 
 TDiracMatrix &TDiracMatrix::Invert()
 {
-   if (Determ() == 0.L) {
+   if (Determ() == (LDouble_t)0) {
       Error("TDiracMatrix::Invert()","matrix is singular!");
       return *this;
    }
@@ -380,8 +380,8 @@ void TDiracMatrix::Streamer(TBuffer &buf)
       int n=0;
       for (int mu=0; mu < 4; ++mu) {
          for (int nu=0; nu < 4; ++nu, ++n) {
-            vector[n] = fMatrix[mu][nu].real();
-            vector[n+1] = fMatrix[mu][nu].imag();
+            vector[n] = (Double_t)fMatrix[mu][nu].real();
+            vector[n+1] = (Double_t)fMatrix[mu][nu].imag();
          }
       }
       buf.WriteArray(vector, 32);
@@ -189,7 +189,7 @@ public:
 inline TDiracMatrix::TDiracMatrix(const Int_t a)
 {
    Zero();
-   SetDiagonal(a);
+   SetDiagonal(Complex_t(a));
 }
 
 inline TDiracMatrix::TDiracMatrix(const LDouble_t a)
@@ -236,7 +236,7 @@ inline LDouble_t TDiracMatrix::Resolution() const
 
 inline Bool_t TDiracMatrix::IsIdentity() const
 {
-   const TDiracMatrix one(1.0L);
+   const TDiracMatrix one((LDouble_t)1);
    return (*this == one);
 }
 
@@ -301,7 +301,7 @@ inline Complex_t TDiracMatrix::Component(const EDiracIndex i) const
 
    TDiracMatrix g(i);
    g *= *this;
-   return (g.Trace() / ((i>0 && i<4) ? -4.L : 4.L));
+   return (g.Trace() / (LDouble_t)((i>0 && i<4) ? -4 : 4));
 }
 
 inline Complex_t TDiracMatrix::Component(const EDiracIndex i,
@@ -314,7 +314,7 @@ inline Complex_t TDiracMatrix::Component(const EDiracIndex i,
 
    TDiracMatrix g(i,j);
    g *= *this;
-   return (g.Trace() / ((i>0 && i<4) ? -2.L : 2.L) / ((j>0 && j<4) ? -2.L : 2.L));
+   return (g.Trace() / (LDouble_t)((i>0 && i<4) ? -2 : 2) / (LDouble_t)((j>0 && j<4) ? -2 : 2));
 }
 
 inline void TDiracMatrix::GetDiagonal(Complex_t &a11, Complex_t &a22,
@@ -394,7 +394,7 @@ inline TDiracMatrix &TDiracMatrix::operator*=(const TDiracMatrix &source)
    TDiracMatrix copy(*this);
    for (Int_t i=0; i<4; i++)
       for (Int_t j=0; j<4; j++) {
-         Complex_t sum=0;
+         Complex_t sum(0);
          for (Int_t k=0; k<4; k++)
             sum += copy.fMatrix[i][k]*source.fMatrix[k][j];
          fMatrix[i][j] = sum;
@@ -725,8 +725,8 @@ inline TBuffer &operator<<(TBuffer &buf, const TDiracMatrix *obj)
 {
    for (Int_t i=0; i<4; i++) {
       for (Int_t j=0; j<4; j++) {
-         Double_t real = obj->fMatrix[i][j].real();
-         Double_t imag = obj->fMatrix[i][j].imag();
+         Double_t real = (Double_t)obj->fMatrix[i][j].real();
+         Double_t imag = (Double_t)obj->fMatrix[i][j].imag();
          buf << real << imag;
       }
    }
@@ -289,14 +289,14 @@ void TDiracSpinor::Streamer(TBuffer &buf)
       fSpinor[2] = Complex_t(vector[4], vector[5]);
       fSpinor[3] = Complex_t(vector[6], vector[7]);
    } else {
-      vector[0] = fSpinor[0].real();
-      vector[1] = fSpinor[0].imag();
-      vector[2] = fSpinor[1].real();
-      vector[3] = fSpinor[1].imag();
-      vector[4] = fSpinor[2].real();
-      vector[5] = fSpinor[2].imag();
-      vector[6] = fSpinor[3].real();
-      vector[7] = fSpinor[3].imag();
+      vector[0] = (Double_t)fSpinor[0].real();
+      vector[1] = (Double_t)fSpinor[0].imag();
+      vector[2] = (Double_t)fSpinor[1].real();
+      vector[3] = (Double_t)fSpinor[1].imag();
+      vector[4] = (Double_t)fSpinor[2].real();
+      vector[5] = (Double_t)fSpinor[2].imag();
+      vector[6] = (Double_t)fSpinor[3].real();
+      vector[7] = (Double_t)fSpinor[3].imag();
       buf.WriteArray(vector, 8);
    }
 }
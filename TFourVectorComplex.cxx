@@ -134,14 +134,14 @@ void TFourVectorComplex::Streamer(TBuffer &buf)
       fVector[2] = Complex_t(vector[4], vector[5]);
       fVector[3] = Complex_t(vector[6], vector[7]);
    } else {
-      vector[0] = fVector[0].real();
-      vector[1] = fVector[0].imag();
-      vector[2] = fVector[1].real();
-      vector[3] = fVector[1].imag();
-      vector[4] = fVector[2].real();
-      vector[5] = fVector[2].imag();
-      vector[6] = fVector[3].real();
-      vector[7] = fVector[3].imag();
+      vector[0] = (Double_t)fVector[0].real();
+      vector[1] = (Double_t)fVector[0].imag();
+      vector[2] = (Double_t)fVector[1].real();
+      vector[3] = (Double_t)fVector[1].imag();
+      vector[4] = (Double_t)fVector[2].real();
+      vector[5] = (Double_t)fVector[2].imag();
+      vector[6] = (Double_t)fVector[3].real();
+      vector[7] = (Double_t)fVector[3].imag();
       buf.WriteArray(vector, 8);
    }
 }
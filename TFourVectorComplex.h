@@ -568,8 +568,8 @@ inline TBuffer &operator<<(TBuffer &buf, const TFourVectorComplex *obj)
 {
 // This method assumes that complex is stored in memory as LDouble_t[2]
    for (Int_t i=0; i<4; i++) {
-      Double_t real = obj->fVector[i].real();
-      Double_t imag = obj->fVector[i].imag();
+      Double_t real = (Double_t)obj->fVector[i].real();
+      Double_t imag = (Double_t)obj->fVector[i].imag();
       buf << real << imag;
    }
    return buf;
@@ -132,10 +132,10 @@ void TFourVectorReal::Streamer(TBuffer &buf)
       fVector[2] = vector[2];
       fVector[3] = vector[3];
    } else {
-      vector[0] = fVector[0];
-      vector[1] = fVector[1];
-      vector[2] = fVector[2];
-      vector[3] = fVector[3];
+      vector[0] = (Double_t)fVector[0];
+      vector[1] = (Double_t)fVector[1];
+      vector[2] = (Double_t)fVector[2];
+      vector[3] = (Double_t)fVector[3];
       buf.WriteArray(vector, 4);
    }
 }
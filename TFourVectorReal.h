@@ -417,10 +417,10 @@ inline TBuffer &operator>>(TBuffer &buf, TFourVectorReal *&obj)
 inline TBuffer &operator<<(TBuffer &buf, const TFourVectorReal *obj)
 {
    Double_t vector[4];
-   vector[0] = obj->fVector[0];
-   vector[1] = obj->fVector[1];
-   vector[2] = obj->fVector[2];
-   vector[3] = obj->fVector[3];
+   vector[0] = (Double_t)obj->fVector[0];
+   vector[1] = (Double_t)obj->fVector[1];
+   vector[2] = (Double_t)obj->fVector[2];
+   vector[3] = (Double_t)obj->fVector[3];
    buf.WriteArray(vector, 4);
    return buf;
 }
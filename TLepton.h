@@ -128,7 +128,7 @@ inline TBuffer &operator<<(TBuffer &buf, const TLepton *obj)
 {
    TFourVectorReal *mom=(TFourVectorReal *)&obj->fMomentum;
    TPauliMatrix *sdm=(TPauliMatrix *)&obj->fSpinDensity;
-   Double_t mass = obj->fMass;
+   Double_t mass = (Double_t)obj->fMass;
    buf << mass;
    buf << mom;
    buf << sdm;
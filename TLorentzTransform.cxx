@@ -152,7 +152,7 @@ TFourVectorComplex TLorentzTransform::operator*
 {
    TFourVectorComplex result;
    for (Int_t i=0; i<4; i++) {
-      Complex_t sum=0;
+      Complex_t sum(0);
       for (Int_t j=0; j<4; j++) {
          sum += fMatrix[i][j]*vec.fVector[j];
       }
@@ -218,7 +218,7 @@ void TLorentzTransform::Streamer(TBuffer &buf)
    } else {
       for (int mu=0; mu < 4; ++mu)
          for (int nu=0; nu < 4; ++nu)
-            matrix[mu][nu] = fMatrix[mu][nu];
+            matrix[mu][nu] = (Double_t)fMatrix[mu][nu];
       buf.WriteArray(&matrix[0][0], 16);
    }
 }
@@ -276,7 +276,7 @@ Complex_t TDeterminor::Minor(const Complex_t *matrix, const Int_t ncol)
    // with ncol columns.  The matrix can be stored row-wise or column-wise.
 
    if (ncol == 0) return matrix[fRow[0]];
-   Complex_t result=0;
+   Complex_t result(0);
    for (Int_t col=0; col<ncol; col++) {
       Swap(fRow[col],fRow[ncol]);
       result -= matrix[fRow[ncol]+ncol*fDim]*Minor(matrix,ncol-1);
@@ -292,14 +292,15 @@ TInvertor::TInvertor(const Int_t dim)
       Error("TInvertor::TInvertor","dimension nonpositive");
    }
    fDim = dim;
-   fPivot = new Int_t[dim];
+   fPivot = (dim > kFixedDim)? new Int_t[dim] : fFixedPivot;
    for (Int_t i=0; i<dim; i++)
       fPivot[i] = i;
 }
 
 TInvertor::~TInvertor()
 {
-   delete [] fPivot;
+   if (fPivot != fFixedPivot)
+      delete [] fPivot;
 }
 
 Float_t *TInvertor::Invert(Float_t *matrix)
@@ -312,8 +313,9 @@ Float_t *TInvertor::Invert(const Float_t *matrix, Float_t *inverse)
    // Invert matrix into inverse using a pivoting method. 
 
    const Int_t nelem = fDim*fDim;
-   Float_t *work = new Float_t[nelem];
-   Float_t *winv = new Float_t[nelem];
+   Float_t fixed[2*kFixedDim*kFixedDim];
+   Float_t *work = (fDim > kFixedDim)? new Float_t[2*nelem] : fixed;
+   Float_t *winv = work + nelem;
    const Float_t *m = matrix;
    Float_t *w = work;
    Float_t *v = winv;
@@ -335,10 +337,10 @@ Float_t *TInvertor::Invert(const Float_t *matrix, Float_t *inverse)
       Int_t r = fPivot[row];                   // swapping rows as needed
       LDouble_t norm = work[row*fDim+r];
       for (Int_t i=0; i<fDim; i++)
-         inverse[r*fDim+i] = winv[row*fDim+i]/norm;
+         inverse[r*fDim+i] = (Float_t)(winv[row*fDim+i]/norm);
    }
-   delete [] work;
-   delete [] winv;
+   if (work != fixed)
+      delete [] work;
    return inverse;
 }
 
@@ -352,8 +354,9 @@ LDouble_t *TInvertor::Invert(const LDouble_t *matrix, LDouble_t *inverse)
    // Invert matrix into inverse using a pivoting method. 
 
    const Int_t nelem = fDim*fDim;
-   LDouble_t *work = new LDouble_t[nelem];
-   LDouble_t *winv= new LDouble_t[nelem];
+   LDouble_t fixed[2*kFixedDim*kFixedDim];
+   LDouble_t *work = (fDim > kFixedDim)? new LDouble_t[2*nelem] : fixed;
+   LDouble_t *winv = work + nelem;
    const LDouble_t *m = matrix;
    LDouble_t *w = work;
    LDouble_t *v = winv;
@@ -377,8 +380,8 @@ LDouble_t *TInvertor::Invert(const LDouble_t *matrix, LDouble_t *inverse)
       for (Int_t i=0; i<fDim; i++)
          inverse[r*fDim+i] = winv[row*fDim+i]/norm;
    }
-   delete [] work;
-   delete [] winv;
+   if (work != fixed)
+      delete [] work;
    return inverse;
 }
 
@@ -393,8 +396,9 @@ Complex_t *TInvertor::Invert
    // Invert matrix into inverse using a pivoting method. 
 
    const Int_t nelem = fDim*fDim;
-   Complex_t *work = new Complex_t[nelem];
-   Complex_t *winv = new Complex_t[nelem];
+   Complex_t fixed[2*kFixedDim*kFixedDim];
+   Complex_t *work = (fDim > kFixedDim)? new Complex_t[2*nelem] : fixed;
+   Complex_t *winv = work + nelem;
    const Complex_t *m = matrix;
    Complex_t *w = work;
    Complex_t *v = winv;
@@ -418,8 +422,8 @@ Complex_t *TInvertor::Invert
       for (Int_t i=0; i<fDim; i++)
          inverse[r*fDim+i] = winv[row*fDim+i]/norm;
    }
-   delete [] work;
-   delete [] winv;
+   if (work != fixed)
+      delete [] work;
    return inverse;
 }
 
@@ -498,12 +502,12 @@ void TInvertor::PivotRow
    p2[jpivot] = 0;
    for (Int_t j=row1+1; j<fDim; j++) {
       Int_t jtarget = fPivot[j];
-      p2[jtarget] -= p1[jtarget]*pfactor;
+      p2[jtarget] -= (Float_t)(p1[jtarget]*pfactor);
    }
    p1 = inverse + fDim*row1;
    p2 = inverse + fDim*row2;
    for (Int_t j=0; j<fDim; j++) {
-      p2[j] -= p1[j]*pfactor;
+      p2[j] -= (Float_t)(p1[j]*pfactor);
    }
 }
 
@@ -76,10 +76,15 @@ class TDeterminor {
 // a square matrix.  It uses recursive procedure to cover any size of
 // square matrix, using a permutation iteration method.  Matrices of
 // Float_t, LDouble_t and Complex_t elements are currently supported.
+// Matrices up to kFixedDim rows are handled without any heap allocation.
+
+public:
+   enum { kFixedDim = 4 };
 
 private:
    Int_t fDim;        // dimension of square matrix
    Int_t *fRow;       // permutator array of colIndex->rowIndex
+   Int_t fFixedRow[kFixedDim];   // storage for fRow up to kFixedDim
 
 public:
    TDeterminor() : fDim(0), fRow(0) { }
@@ -97,10 +102,17 @@ class TInvertor {
 // The TInvertor class is a helper for calculating the inverse of a
 // square matrix.  It uses a pivoting (i.e. Gaussian elimination) method.
 // Matrices of Float_t, LDouble_t and Complex_t elements are supported.
+// Matrices up to kFixedDim rows, which covers all of the Dirac, Pauli
+// and Lorentz matrices of the package, are inverted in fixed storage
+// on the stack, without any heap allocation.
+
+public:
+   enum { kFixedDim = 4 };
 
 private:
    Int_t fDim;            // dimension of square matrix
    Int_t *fPivot;        // array of pivot element indices
+   Int_t fFixedPivot[kFixedDim];   // storage for fPivot up to kFixedDim
 
 public:
    TInvertor() : fDim(0), fPivot(0) { }
@@ -214,7 +226,7 @@ inline TBuffer &operator<<(TBuffer &buf, const TLorentzTransform *xOp)
    Double_t matrix[4][4];
    for (int mu=0; mu < 4; ++mu)
       for (int nu=0; nu < 4; ++nu)
-         matrix[mu][nu] = xOp->fMatrix[mu][nu];
+         matrix[mu][nu] = (Double_t)xOp->fMatrix[mu][nu];
    buf.WriteArray(&matrix[0][0], 16);
    return buf;
 }
@@ -227,12 +239,16 @@ inline LDouble_t TLorentzTransform::Determ() const
 
 inline TDeterminor::TDeterminor(const Int_t dim) : fDim(dim)
 {
-   fRow = new Int_t[dim];
+   fRow = (dim > kFixedDim)? new Int_t[dim] : fFixedRow;
    for (Int_t i=0; i<dim; i++)
       fRow[i] = i;
 }
 
-inline TDeterminor::~TDeterminor() { delete [] fRow; }
+inline TDeterminor::~TDeterminor()
+{
+   if (fRow != fFixedRow)
+      delete [] fRow;
+}
 
 inline void TDeterminor::Swap(Int_t &a, Int_t &b)
 {
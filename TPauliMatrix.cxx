@@ -109,10 +109,10 @@ void TPauliMatrix::Decompose(LDouble_t &a, TThreeVectorReal &b) const
 void TPauliMatrix::Decompose(Complex_t &a, TThreeVectorComplex &b) const
 {
    const Complex_t i_(0,1);
-   a    = (fMatrix[0][0] + fMatrix[1][1])/2.L;
-   b[1] = (fMatrix[1][0] + fMatrix[0][1])/2.L;
-   b[2] = (fMatrix[1][0] - fMatrix[0][1])/(2.L*i_);
-   b[3] = (fMatrix[0][0] - fMatrix[1][1])/2.L;
+   a    = (fMatrix[0][0] + fMatrix[1][1])/(LDouble_t)2;
+   b[1] = (fMatrix[1][0] + fMatrix[0][1])/(LDouble_t)2;
+   b[2] = (fMatrix[1][0] - fMatrix[0][1])/((LDouble_t)2*i_);
+   b[3] = (fMatrix[0][0] - fMatrix[1][1])/(LDouble_t)2;
 }
 
 TPauliMatrix &TPauliMatrix::operator*=(const TPauliMatrix &source)
@@ -261,14 +261,14 @@ void TPauliMatrix::Streamer(TBuffer &buf)
       fMatrix[1][0] = Complex_t(vector[4], vector[5]);
       fMatrix[1][1] = Complex_t(vector[6], vector[7]);
    } else {
-      vector[0] = fMatrix[0][0].real();
-      vector[1] = fMatrix[0][0].imag();
-      vector[2] = fMatrix[0][1].real();
-      vector[3] = fMatrix[0][1].imag();
-      vector[4] = fMatrix[1][0].real();
-      vector[5] = fMatrix[1][0].imag();
-      vector[6] = fMatrix[1][1].real();
-      vector[7] = fMatrix[1][1].imag();
+      vector[0] = (Double_t)fMatrix[0][0].real();
+      vector[1] = (Double_t)fMatrix[0][0].imag();
+      vector[2] = (Double_t)fMatrix[0][1].real();
+      vector[3] = (Double_t)fMatrix[0][1].imag();
+      vector[4] = (Double_t)fMatrix[1][0].real();
+      vector[5] = (Double_t)fMatrix[1][0].imag();
+      vector[6] = (Double_t)fMatrix[1][1].real();
+      vector[7] = (Double_t)fMatrix[1][1].imag();
       buf.WriteArray(vector, 8);
    }
 }
@@ -38,7 +38,9 @@ public:
    explicit TPauliMatrix(const Int_t a);
    explicit TPauliMatrix(const Float_t a);
    explicit TPauliMatrix(const Double_t a);
+#if !defined DIRACXX_DOUBLE
    explicit TPauliMatrix(const LDouble_t a);
+#endif
    explicit TPauliMatrix(const Complex_t &a);
    explicit TPauliMatrix(const Complex_t &a, const TThreeVectorComplex &b);
    TPauliMatrix(const TPauliMatrix &another);
@@ -154,11 +156,13 @@ inline TPauliMatrix::TPauliMatrix(const Double_t a)
    fMatrix[1][0] = 0;    fMatrix[1][1] = a;
 }
 
+#if !defined DIRACXX_DOUBLE
 inline TPauliMatrix::TPauliMatrix(const LDouble_t a)
 {
    fMatrix[0][0] = a;    fMatrix[0][1] = 0;
    fMatrix[1][0] = 0;    fMatrix[1][1] = a;
 }
+#endif
 
 inline TPauliMatrix::TPauliMatrix(const Complex_t &a)
 {
@@ -199,7 +203,7 @@ inline LDouble_t TPauliMatrix::Resolution() const
 
 inline Bool_t TPauliMatrix::IsIdentity() const
 {
-   const TPauliMatrix one(1.0L);
+   const TPauliMatrix one((LDouble_t)1);
    return (*this == one);
 }
 
@@ -497,8 +501,8 @@ inline TBuffer &operator<<(TBuffer &buf, const TPauliMatrix *obj)
 {
    for (Int_t i=0; i<2; i++) {
       for (Int_t j=0; j<2; j++) {
-         Double_t real = obj->fMatrix[i][j].real();
-         Double_t imag = obj->fMatrix[i][j].imag();
+         Double_t real = (Double_t)obj->fMatrix[i][j].real();
+         Double_t imag = (Double_t)obj->fMatrix[i][j].imag();
          buf << real << imag;
       }
    }
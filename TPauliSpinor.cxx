@@ -144,10 +144,10 @@ void TPauliSpinor::Streamer(TBuffer &buf)
       fSpinor[0] = Complex_t(vector[0], vector[1]);
       fSpinor[1] = Complex_t(vector[2], vector[3]);
    } else {
-      vector[0] = fSpinor[0].real();
-      vector[1] = fSpinor[0].imag();
-      vector[2] = fSpinor[1].real();
-      vector[3] = fSpinor[1].imag();
+      vector[0] = (Double_t)fSpinor[0].real();
+      vector[1] = (Double_t)fSpinor[0].imag();
+      vector[2] = (Double_t)fSpinor[1].real();
+      vector[3] = (Double_t)fSpinor[1].imag();
       buf.WriteArray(vector, 4);
    }
 }
@@ -449,8 +449,8 @@ inline TBuffer &operator>>(TBuffer &buf, TPauliSpinor *&obj)
 inline TBuffer &operator<<(TBuffer &buf, const TPauliSpinor *obj)
 {
    for (Int_t i=0; i<2; i++) {
-      Double_t real = obj->fSpinor[i].real();
-      Double_t imag = obj->fSpinor[i].imag();
+      Double_t real = (Double_t)obj->fSpinor[i].real();
+      Double_t imag = (Double_t)obj->fSpinor[i].imag();
       buf << real << imag;
    }
    return buf;
@@ -102,7 +102,7 @@ TFourVectorComplex TPhoton::Eps(const Int_t mode) const
    // convention with the particle density of a unit-amplitude plane wave
    // given by 2E.
 
-   TThreeVectorComplex xhat,yhat,zhat(0,0,1);
+   TThreeVectorComplex xhat,yhat,zhat(TThreeVectorReal(0,0,1));
    yhat.Cross(zhat,fMomentum);
    if (yhat.Length() > yhat.Resolution()) {
       xhat.Cross(yhat,fMomentum);
@@ -138,7 +138,7 @@ TFourVectorComplex TPhoton::Eps(const Int_t mode) const
       else if (norm < 0)
          eps /= sqrt(-norm);
       else
-         eps = TFourVectorComplex(0,0,0,0);
+         eps.Zero();
       break;
    }
    return eps;
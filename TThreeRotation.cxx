@@ -270,7 +270,7 @@ TThreeVectorComplex TThreeRotation::operator*
 {
    TThreeVectorComplex result;
    for (Int_t i=1; i<4; i++) {
-      Complex_t sum=0;
+      Complex_t sum(0);
       for (Int_t j=1; j<4; j++) {
          sum += fMatrix[i][j]*vec.fVector[j];
       }
@@ -103,12 +103,12 @@ void TThreeVectorComplex::Streamer(TBuffer &buf)
       fVector[2] = Complex_t(vector[2], vector[3]);
       fVector[3] = Complex_t(vector[4], vector[5]);
    } else {
-      vector[0] = fVector[1].real();
-      vector[1] = fVector[1].imag();
-      vector[2] = fVector[2].real();
-      vector[3] = fVector[2].imag();
-      vector[4] = fVector[3].real();
-      vector[5] = fVector[3].imag();
+      vector[0] = (Double_t)fVector[1].real();
+      vector[1] = (Double_t)fVector[1].imag();
+      vector[2] = (Double_t)fVector[2].real();
+      vector[3] = (Double_t)fVector[2].imag();
+      vector[4] = (Double_t)fVector[3].real();
+      vector[5] = (Double_t)fVector[3].imag();
       buf.WriteArray(vector, 6);
    }
 }
@@ -505,8 +505,8 @@ inline TBuffer &operator>>(TBuffer &buf, TThreeVectorComplex *&obj)
 inline TBuffer &operator<<(TBuffer &buf, const TThreeVectorComplex *obj)
 {
    for (Int_t i=1; i<4; i++) {
-      Double_t real = obj->fVector[i].real();
-      Double_t imag = obj->fVector[i].imag();
+      Double_t real = (Double_t)obj->fVector[i].real();
+      Double_t imag = (Double_t)obj->fVector[i].imag();
       buf << real << imag;
    }
    return buf;
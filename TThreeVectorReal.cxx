@@ -106,9 +106,9 @@ void TThreeVectorReal::Streamer(TBuffer &buf)
       fVector[2] = vector[1];
       fVector[3] = vector[2];
    } else {
-      vector[0] = fVector[1];
-      vector[1] = fVector[2];
-      vector[2] = fVector[3];
+      vector[0] = (Double_t)fVector[1];
+      vector[1] = (Double_t)fVector[2];
+      vector[2] = (Double_t)fVector[3];
       buf.WriteArray(vector, 3);
    }
 }
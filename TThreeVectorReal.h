@@ -464,9 +464,9 @@ inline TBuffer &operator>>(TBuffer &buf, TThreeVectorReal *&obj)
 inline TBuffer &operator<<(TBuffer &buf, const TThreeVectorReal *obj)
 {
    Double_t vector[3];
-   vector[0] = obj->fVector[1];
-   vector[1] = obj->fVector[2];
-   vector[2] = obj->fVector[3];
+   vector[0] = (Double_t)obj->fVector[1];
+   vector[1] = (Double_t)obj->fVector[2];
+   vector[2] = (Double_t)obj->fVector[3];
    buf.WriteArray(vector, 3);
    return buf;
 }
@@ -0,0 +1,316 @@
+//
+// Trace.h
+//
+// This file is distributed as part of the Dirac++ package,
+// a general toolkit for computing the amplitudes for Feynman
+// graphs. See DiracPackage.h for details.
+//
+// Event tracing of the multithreaded generators, so that the stalls,
+// idle threads and load imbalance of a long run can be seen on a time
+// line, which the aggregate times of Profiler.h do not show.
+//
+// Each thread records the start and duration of its traced blocks, the
+// values of counters such as queue depths, and instant markers such as
+// I/O flushes, into its own ring buffer of fixed size, so that the most
+// recent part of an arbitrarily long run is kept without locking or
+// allocating while it is being traced.  The buffers of all threads are
+// written by Trace_write as a Chrome trace JSON file, which can be
+// opened offline in Perfetto (ui.perfetto.dev) or chrome://tracing.
+//
+// The trace points are compiled in together with the timers of
+// Profiler.h, when DIRACXX_PROFILE is defined, and otherwise the macros
+// expand to nothing.  When compiled in, they cost one relaxed atomic
+// load each until tracing is switched on at run time by Trace_enable.
+// The names passed to the macros must be string literals, since only
+// the pointers are stored.
+
+#ifndef DIRACXX_TRACE
+#define DIRACXX_TRACE
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdio.h>
+
+#include "Profiler.h"
+
+enum ETrace_phase {
+   kTraceComplete = 'X',
+   kTraceCounter = 'C',
+   kTraceInstant = 'i'
+};
+
+struct Trace_event_t {
+   const char *name;
+   ULong64_t start;      // ticks, see Profiler_ticks
+   ULong64_t duration;   // ticks, for complete events
+   Double_t value;       // for counters
+   Char_t phase;         // one of ETrace_phase
+};
+
+struct Trace_buffer_t {
+
+   // The ring buffer of one thread.  Only the owning thread writes to it,
+   // and the total number of events recorded is kept in count, so that
+   // the oldest events are overwritten once it is full.
+
+   std::vector<Trace_event_t> events;
+   std::atomic<ULong64_t> count;
+   Int_t tid;
+   std::string name;
+
+   Trace_buffer_t(Int_t id, UInt_t capacity)
+    : events(capacity), count(0), tid(id) { }
+};
+
+struct Trace_registry_t {
+   std::atomic<Bool_t> enabled;
+   std::mutex lock;
+   std::vector<Trace_buffer_t*> buffers;   // one per trace lane
+   std::vector<Trace_buffer_t*> idle;      // lanes of threads that exited
+   UInt_t capacity;                        // events per thread
+   ULong64_t origin;                       // ticks at Trace_enable
+
+   Trace_registry_t() : enabled(false), capacity(1 << 14), origin(0) { }
+};
+
+inline Trace_registry_t &Trace_registry()
+{
+   static Trace_registry_t registry;
+   return registry;
+}
+
+struct Trace_owner_t {
+
+   // Holds the buffer of a thread, and hands it on to the next thread
+   // that starts tracing when this one exits, so that the generators
+   // that start new threads for each pass only need as many buffers as
+   // they run threads at once.  Each buffer appears as one lane in the
+   // trace, with the events of the successive threads that used it.
+
+   Trace_buffer_t *buffer;
+
+   Trace_owner_t() : buffer(0) { }
+   ~Trace_owner_t()
+   {
+      if (buffer) {
+         Trace_registry_t &reg = Trace_registry();
+         std::lock_guard<std::mutex> guard(reg.lock);
+         reg.idle.push_back(buffer);
+      }
+   }
+};
+
+inline Trace_buffer_t *Trace_buffer()
+{
+   // Returns the ring buffer of the calling thread, taking an idle one
+   // or allocating and registering a new one the first time.
+
+   static thread_local Trace_owner_t owner;
+   if (owner.buffer == 0) {
+      Trace_registry_t &reg = Trace_registry();
+      std::lock_guard<std::mutex> guard(reg.lock);
+      if (reg.idle.size() > 0) {
+         owner.buffer = reg.idle.back();
+         reg.idle.pop_back();
+      }
+      else {
+         owner.buffer = new Trace_buffer_t(reg.buffers.size() + 1,
+                                           reg.capacity);
+         reg.buffers.push_back(owner.buffer);
+      }
+   }
+   return owner.buffer;
+}
+
+inline Bool_t Trace_enabled()
+{
+   return Trace_registry().enabled.load(std::memory_order_relaxed);
+}
+
+inline void Trace_record(const char *name, Char_t phase, ULong64_t start,
+                         ULong64_t duration=0, Double_t value=0)
+{
+   Trace_buffer_t *buffer = Trace_buffer();
+   ULong64_t count = buffer->count.load(std::memory_order_relaxed);
+   Trace_event_t &event = buffer->events[count % buffer->events.size()];
+   event.name = name;
+   event.start = start;
+   event.duration = duration;
+   event.value = value;
+   event.phase = phase;
+   buffer->count.store(count + 1, std::memory_order_release);
+}
+
+inline void Trace_counter(const char *name, Double_t value)
+{
+   if (Trace_enabled())
+      Trace_record(name, kTraceCounter, Profiler_ticks(), 0, value);
+}
+
+inline void Trace_instant(const char *name)
+{
+   if (Trace_enabled())
+      Trace_record(name, kTraceInstant, Profiler_ticks());
+}
+
+inline void Trace_thread(const char *name, Int_t index=-1)
+{
+   // Labels the calling thread in the trace, as "name index" if index
+   // is not negative.
+
+   if (!Trace_enabled())
+      return;
+   char label[256];
+   if (index < 0)
+      snprintf(label, sizeof(label), "%s", name);
+   else
+      snprintf(label, sizeof(label), "%s %d", name, index);
+   Trace_buffer_t *buffer = Trace_buffer();
+   std::lock_guard<std::mutex> guard(Trace_registry().lock);
+   buffer->name = label;
+}
+
+class Trace_scope_t {
+
+   // Records the enclosing block as one complete event of the calling
+   // thread when it ends.
+
+public:
+   explicit Trace_scope_t(const char *name)
+    : fName(0)
+   {
+      if (!Trace_enabled())
+         return;
+      fName = name;
+      fStart = Profiler_ticks();
+   }
+
+   ~Trace_scope_t()
+   {
+      if (fName)
+         Trace_record(fName, kTraceComplete, fStart,
+                      Profiler_ticks() - fStart);
+   }
+
+private:
+   const char *fName;
+   ULong64_t fStart;
+};
+
+#if defined DIRACXX_PROFILE
+#define DIRACXX_TRACE_SCOPE(name)                                          \
+   Trace_scope_t DIRACXX_PROFILE_CONCAT(traceScope, __LINE__)(name)
+#define DIRACXX_TRACE_COUNTER(name, value) Trace_counter(name, value)
+#define DIRACXX_TRACE_INSTANT(name) Trace_instant(name)
+#define DIRACXX_TRACE_THREAD(name, index) Trace_thread(name, index)
+#else
+#define DIRACXX_TRACE_SCOPE(name)
+#define DIRACXX_TRACE_COUNTER(name, value)
+#define DIRACXX_TRACE_INSTANT(name)
+#define DIRACXX_TRACE_THREAD(name, index)
+#endif
+
+//----- output -----------------------------------------------------------------
+
+inline void Trace_enable(Bool_t on, UInt_t capacity=1 << 14)
+{
+   // Switches tracing on or off for all threads.  Switching it on also
+   // discards whatever was recorded before, and sets the number of
+   // events kept per lane to capacity for the lanes that have not been
+   // allocated yet.  It should only be switched on while no traced
+   // threads are running.
+
+   Trace_registry_t &reg = Trace_registry();
+   if (on) {
+      std::lock_guard<std::mutex> guard(reg.lock);
+      reg.capacity = (capacity > 0)? capacity : 1;
+      for (UInt_t i=0; i < reg.buffers.size(); i++)
+         reg.buffers[i]->count.store(0);
+      reg.origin = Profiler_ticks();
+   }
+   reg.enabled.store(on);
+}
+
+inline Int_t Trace_write(const char *filename)
+{
+   // Writes the events held in the buffers of all threads to filename as
+   // a Chrome trace JSON file, with times in us from the last call to
+   // Trace_enable.  It should be called once the traced threads are done,
+   // for example after the generator returns.  Returns the number of
+   // events written, or -1 if the file could not be written.
+
+   std::ofstream out(filename);
+   if (!out) {
+      std::cerr << "Trace_write error: cannot open output file "
+                << filename << std::endl;
+      return -1;
+   }
+   Trace_registry_t &reg = Trace_registry();
+   std::lock_guard<std::mutex> guard(reg.lock);
+   Double_t usPerTick = Profiler_ns_per_tick() * 1e-3;
+   Int_t nwritten = 0;
+   ULong64_t dropped = 0;
+   char line[512];
+   out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [" << std::endl;
+   for (UInt_t b=0; b < reg.buffers.size(); b++) {
+      Trace_buffer_t *buffer = reg.buffers[b];
+      ULong64_t count = buffer->count.load(std::memory_order_acquire);
+      ULong64_t size = buffer->events.size();
+      ULong64_t first = (count > size)? count - size : 0;
+      dropped += first;
+      std::string label = (buffer->name.size() > 0)? buffer->name :
+                          std::string("thread");
+      snprintf(line, sizeof(line),
+               "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1,"
+               " \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+               (nwritten > 0)? ",\n" : "", buffer->tid, label.c_str());
+      out << line;
+      ++nwritten;
+      for (ULong64_t n=first; n < count; n++) {
+         const Trace_event_t &event = buffer->events[n % size];
+         if (event.start < reg.origin)
+            continue;
+         Double_t ts = (event.start - reg.origin) * usPerTick;
+         if (event.phase == kTraceComplete) {
+            snprintf(line, sizeof(line),
+                     ",\n{\"ph\": \"X\", \"name\": \"%s\", \"pid\": 1,"
+                     " \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}",
+                     event.name, buffer->tid, ts,
+                     event.duration * usPerTick);
+         }
+         else if (event.phase == kTraceCounter) {
+            snprintf(line, sizeof(line),
+                     ",\n{\"ph\": \"C\", \"name\": \"%s\", \"pid\": 1,"
+                     " \"tid\": %d, \"id\": %d, \"ts\": %.3f,"
+                     " \"args\": {\"value\": %.17g}}",
+                     event.name, buffer->tid, buffer->tid, ts, event.value);
+         }
+         else {
+            snprintf(line, sizeof(line),
+                     ",\n{\"ph\": \"i\", \"name\": \"%s\", \"pid\": 1,"
+                     " \"tid\": %d, \"ts\": %.3f, \"s\": \"t\"}",
+                     event.name, buffer->tid, ts);
+         }
+         out << line;
+         ++nwritten;
+      }
+   }
+   out << std::endl << "]}" << std::endl;
+   if (!out) {
+      std::cerr << "Trace_write error: write failed on output file "
+                << filename << std::endl;
+      return -1;
+   }
+   if (dropped > 0) {
+      std::cerr << "Trace_write warning: the oldest " << dropped
+                << " events were overwritten, only the last "
+                << reg.capacity << " per lane are kept" << std::endl;
+   }
+   return nwritten;
+}
+
+#endif
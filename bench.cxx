@@ -0,0 +1,873 @@
+//
+// bench.cxx
+//
+// Measures the time per call of each of the cross section methods of
+// TCrossSection at representative kinematics like those of the demo
+// functions in Compton.C, Brems.C, Pairs.C and Triplets.C, together with
+// the Dirac algebra kernels that dominate them: matrix products, the
+// spinor constructors, the slash and scalar products, Lorentz boosts and
+// the spin sums over the amplitude tensor.  The results are written as
+// a JSON document that also records the cpu, compiler and scalar type
+// of the build, so that the output from different versions of the
+// package can be compared to look for performance regressions.
+//
+// usage: bench [output file] [seconds per benchmark] [name filter]
+//
+// If no output file is given, or it is "-", the JSON is written to
+// stdout.  The progress of the benchmarks is printed to stderr.  Each
+// benchmark is timed over 5 rounds of repeated calls, each lasting about
+// 1/5 of the requested time (default 0.5 s), and the median and minimum
+// times per call over the rounds are reported.  If a name filter is
+// given, only the benchmarks whose names contain it are run.
+//
+// Where the kernel allows it (see perf_event_open(2) and the setting of
+// /proc/sys/kernel/perf_event_paranoid), the hardware performance
+// counters for cycles, instructions, L1 data and last-level cache read
+// misses, branch misses and floating point operations are read over the
+// timed rounds of each benchmark, and reported per call together with
+// the instructions per cycle and the GFLOP/s.  Any counter that cannot
+// be opened is reported as null.  There is no generic event for floating
+// point operations, so the default on Intel cpus counts the retired
+// scalar SSE operations (FP_ARITH_INST_RETIRED, raw event 0x03c7), which
+// does not include the x87 arithmetic of the long double build.  Another
+// raw event can be chosen by setting BENCH_FP_EVENT to its hex code, for
+// example 0x10b1 (UOPS_EXECUTED.X87 on Skylake) to count the x87 uops.
+//
+// The sampled amplitude validation of TCrossSection, which is on by
+// default, is turned off so that the times are those of the cross
+// sections alone.  To measure its cost, set BENCH_VALIDATION to the
+// validation rate, for example 1e-4, see TCrossSection::SetValidation.
+//
+// The program replaces the global operator new to count the heap
+// allocations made during the timed rounds of each benchmark, which are
+// reported per call.  None of the benchmarked calls is allowed to
+// allocate, since the cross sections are evaluated from many threads at
+// once where malloc becomes a point of contention, so the program exits
+// with status 2 if any of them does, after writing the results.  The
+// same check is made on the steady state of the event pipelines, where
+// the chunks of a Stream_t and the arrays of Batch_vectors_t are reused
+// from their free lists instead of being allocated for every block.
+//
+// author: richard.t.jones at uconn.edu
+// version: october 18, 2026
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#endif
+
+#include "Complex.h"
+#include "TPhoton.h"
+#include "TLepton.h"
+#include "TLorentzBoost.h"
+#include "TDiracSpinor.h"
+#include "TDiracMatrix.h"
+#include "TAmplitudeTensor.h"
+#include "TCrossSection.h"
+#include "constants.h"
+#include "sqr.h"
+#include "Batch.h"
+#include "Stream.h"
+
+#if defined DIRACXX_DOUBLE_DOUBLE
+const char *Bench_build = "double-double";
+#elif defined DIRACXX_FLOAT128
+const char *Bench_build = "quad precision";
+#else
+const char *Bench_build = "long double";
+#endif
+
+const Int_t Bench_rounds = 5;
+
+// Rate of the amplitude validation in TCrossSection, see main.
+Double_t Bench_validation = 0;
+
+// Every benchmarked call adds something to this sum, so that the
+// compiler cannot drop calls whose results would otherwise be unused.
+volatile Double_t Bench_sink = 0;
+
+// Count of the calls to the global operator new, replaced below.
+std::atomic<Long64_t> Bench_allocations(0);
+
+void *operator new(std::size_t size)
+{
+   Bench_allocations.fetch_add(1, std::memory_order_relaxed);
+   void *p = malloc((size > 0)? size : 1);
+   if (p == 0)
+      throw std::bad_alloc();
+   return p;
+}
+
+void *operator new[](std::size_t size)
+{
+   return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+   free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+   free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+   free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+   free(p);
+}
+
+std::string Bench_cpuinfo(const char *key)
+{
+   // Returns the value of the first entry for key in /proc/cpuinfo,
+   // if there is one.
+
+   std::ifstream cpuinfo("/proc/cpuinfo");
+   std::string line;
+   while (std::getline(cpuinfo, line)) {
+      if (line.find(key) == 0 && line.find(':') != std::string::npos)
+         return line.substr(line.find(':') + 2);
+   }
+   return "unknown";
+}
+
+std::string Bench_cpu()
+{
+   return Bench_cpuinfo("model name");
+}
+
+std::string Bench_cpu_vendor()
+{
+   return Bench_cpuinfo("vendor_id");
+}
+
+enum EBench_counter {
+   kBenchCycles = 0,
+   kBenchInstructions = 1,
+   kBenchL1dMisses = 2,
+   kBenchLLCMisses = 3,
+   kBenchBranchMisses = 4,
+   kBenchFPOps = 5,
+   kBenchCounters = 6
+};
+
+const char *Bench_counter_names[kBenchCounters] = {
+   "cycles", "instructions", "l1d_misses", "llc_misses",
+   "branch_misses", "fp_ops"
+};
+
+class Bench_counters_t {
+
+   // Hardware performance counters for the calling thread, counting in
+   // user mode only, opened one at a time rather than as a group so that
+   // those that are supported can be used when the others are not.  If
+   // the kernel multiplexes them, the counts are scaled up by the ratio
+   // of the time enabled to the time counted.  A count that could not
+   // be read, or that was never scheduled, is returned as -1.
+
+public:
+   Bench_counters_t();
+   ~Bench_counters_t();
+
+   Bool_t Available(Int_t c) const { return fFd[c] >= 0; }
+   ULong64_t FPEvent() const { return fFPEvent; }
+   Double_t Count(Int_t c) const { return fCount[c]; }
+   void Start();
+   void Stop();
+
+private:
+   Int_t fFd[kBenchCounters];
+   Double_t fCount[kBenchCounters];
+   ULong64_t fFPEvent;
+};
+
+Bench_counters_t::Bench_counters_t()
+{
+   fFPEvent = 0;
+   const char *fpEvent = getenv("BENCH_FP_EVENT");
+   if (fpEvent) {
+      fFPEvent = strtoull(fpEvent, 0, 16);
+   }
+   else if (Bench_cpu_vendor() == "GenuineIntel") {
+      fFPEvent = 0x03c7;
+   }
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      fFd[c] = -1;
+      fCount[c] = -1;
+   }
+#if defined __linux__
+   const ULong64_t cacheReadMiss = (PERF_COUNT_HW_CACHE_OP_READ << 8) +
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+   const UInt_t type[kBenchCounters] = {
+      PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+      PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW
+   };
+   const ULong64_t config[kBenchCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_L1D + cacheReadMiss,
+      PERF_COUNT_HW_CACHE_LL + cacheReadMiss,
+      PERF_COUNT_HW_BRANCH_MISSES,
+      fFPEvent
+   };
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      if (c == kBenchFPOps && fFPEvent == 0)
+         continue;
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = type[c];
+      attr.config = config[c];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      fFd[c] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+   }
+#endif
+}
+
+Bench_counters_t::~Bench_counters_t()
+{
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      if (fFd[c] >= 0)
+         close(fFd[c]);
+   }
+}
+
+void Bench_counters_t::Start()
+{
+#if defined __linux__
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      if (fFd[c] >= 0) {
+         ioctl(fFd[c], PERF_EVENT_IOC_RESET, 0);
+         ioctl(fFd[c], PERF_EVENT_IOC_ENABLE, 0);
+      }
+   }
+#endif
+}
+
+void Bench_counters_t::Stop()
+{
+#if defined __linux__
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      if (fFd[c] >= 0)
+         ioctl(fFd[c], PERF_EVENT_IOC_DISABLE, 0);
+   }
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      ULong64_t value[3];
+      fCount[c] = -1;
+      if (fFd[c] >= 0 && read(fFd[c], value, sizeof(value)) == sizeof(value)
+          && value[2] > 0)
+      {
+         fCount[c] = value[0] * ((Double_t)value[1] / value[2]);
+      }
+   }
+#endif
+}
+
+Bench_counters_t Bench_perf;
+
+struct Bench_result_t {
+   std::string name;
+   std::string group;
+   Double_t nsPerCall;             // median over the rounds
+   Double_t nsPerCallMin;          // fastest round
+   Long64_t calls;                 // calls per round
+   Double_t counts[kBenchCounters];  // per call, or -1 if not available
+   Double_t allocations;           // heap allocations per call
+};
+
+template <class Func>
+Bench_result_t Bench_time(const char *group, const char *name,
+                          Double_t seconds, Func func)
+{
+   // Calls func repeatedly for the given time, and returns the time per
+   // call.  The number of calls per round is found by doubling it until
+   // one round takes at least 1/Bench_rounds of the requested time.
+
+   typedef std::chrono::steady_clock clock;
+   Bench_result_t result;
+   result.group = group;
+   result.name = name;
+   func();
+   Long64_t calls = 1;
+   Double_t elapsed;
+   while (true) {
+      auto start = clock::now();
+      for (Long64_t n=0; n < calls; n++)
+         func();
+      elapsed = std::chrono::duration<Double_t>(clock::now() - start).count();
+      if (elapsed >= seconds / Bench_rounds || calls >= (1LL << 40))
+         break;
+      calls *= 2;
+   }
+   std::vector<Double_t> ns(Bench_rounds);
+   Long64_t allocations = Bench_allocations.load();
+   Bench_perf.Start();
+   for (Int_t r=0; r < Bench_rounds; r++) {
+      auto start = clock::now();
+      for (Long64_t n=0; n < calls; n++)
+         func();
+      std::chrono::duration<Double_t, std::nano> dt = clock::now() - start;
+      ns[r] = dt.count() / calls;
+   }
+   Bench_perf.Stop();
+   result.allocations = (Double_t)(Bench_allocations.load() - allocations)
+                        / (calls * Bench_rounds);
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      result.counts[c] = (Bench_perf.Count(c) >= 0)?
+                         Bench_perf.Count(c) / (calls * Bench_rounds) : -1;
+   }
+   std::sort(ns.begin(), ns.end());
+   result.nsPerCall = ns[Bench_rounds / 2];
+   result.nsPerCallMin = ns[0];
+   result.calls = calls;
+   std::cerr << name << ": " << result.nsPerCall << " ns/call";
+   if (result.counts[kBenchCycles] > 0 && result.counts[kBenchInstructions] >= 0)
+      std::cerr << ", IPC " << result.counts[kBenchInstructions] /
+                               result.counts[kBenchCycles];
+   if (result.allocations > 0)
+      std::cerr << ", " << result.allocations << " heap allocations/call";
+   std::cerr << std::endl;
+   return result;
+}
+
+void Bench_decay(const TFourVectorReal &P, LDouble_t m1, LDouble_t m2,
+                 LDouble_t costheta, LDouble_t phi,
+                 TFourVectorReal &p1, TFourVectorReal &p2)
+{
+   // Splits the four-momentum P into p1,p2 with masses m1,m2, with p1
+   // at polar angles costheta,phi in the rest frame of P.  Both are
+   // checked to be on their mass shells before any of the timing, so
+   // that no process is timed at kinematics it never sees in practice.
+
+   LDouble_t M = P.Invariant();
+   LDouble_t pStar = sqrt((sqr(M) - sqr(m1 + m2)) * (sqr(M) - sqr(m1 - m2)))
+                     / (2 * M);
+   LDouble_t sintheta = sqrt(1 - sqr(costheta));
+   TThreeVectorReal k(pStar*sintheta*cos(phi),
+                      pStar*sintheta*sin(phi),
+                      pStar*costheta);
+   p1 = TFourVectorReal(sqrt(sqr(pStar) + sqr(m1)), k);
+   TLorentzBoost toLab(-P[1]/P[0], -P[2]/P[0], -P[3]/P[0]);
+   p1.Boost(toLab);
+   p2 = P - p1;
+   const LDouble_t tolerance = 1e-12 * sqr(P[0]);
+   if (fabs(p1.InvariantSqr() - sqr(m1)) > tolerance ||
+       fabs(p2.InvariantSqr() - sqr(m2)) > tolerance)
+   {
+      std::cerr << "error: Bench_decay gives off-shell momenta, p1^2 = "
+                << (Double_t)p1.InvariantSqr() << " for m1^2 = "
+                << (Double_t)sqr(m1) << ", p2^2 = "
+                << (Double_t)p2.InvariantSqr() << " for m2^2 = "
+                << (Double_t)sqr(m2) << std::endl;
+      exit(1);
+   }
+}
+
+TThreeVectorReal Bench_recoil(LDouble_t E, LDouble_t p, LDouble_t M,
+                              LDouble_t qR2)
+{
+   // Returns the recoil momentum qR of magnitude sqrt(qR2) absorbed by a
+   // heavy target from a beam particle of energy E and momentum p along z
+   // that leaves the final state with invariant mass M, as in the
+   // kinematics of Pairs.C and Brems.C.
+
+   LDouble_t qR = sqrt(qR2);
+   LDouble_t costhetaR = (sqr(M) - sqr(E) + sqr(p) + qR2) / (2 * p * qR);
+   return TThreeVectorReal(qR*sqrt(1 - sqr(costhetaR)), 0, qR*costhetaR);
+}
+
+void Bench_processes(Double_t seconds, const std::string &filter,
+                     std::vector<Bench_result_t> &results)
+{
+   // Times each of the cross section methods, with the incoming particles
+   // unpolarized or linearly polarized and the final state spins summed,
+   // as in the demo functions.
+
+   const TThreeVectorReal zhat(0, 0, 1);
+   const TThreeVectorReal unpol(0, 0, 0);
+   const TFourVectorReal eRest(mElectron, 0, 0, 0);
+   const TFourVectorReal pRest(mProton, 0, 0, 0);
+   TFourVectorReal p1, p2, p3, p4, p12, p123;
+
+   // Compton scattering of a 1 GeV photon at 90 degrees in the c.m.
+   TPhoton cgIn, cgOut;
+   TLepton ceIn(mElectron), ceOut(mElectron);
+   cgIn.SetMom((LDouble_t)1 * zhat);
+   ceIn.SetMom(eRest);
+   Bench_decay(cgIn.Mom() + eRest, 0, mElectron, 0, 0.3, p1, p2);
+   cgOut.SetMom(p1);
+   ceOut.SetMom(p2);
+   cgIn.SetPol(TThreeVectorReal(0, 0, 1));
+   ceIn.SetPol(unpol);
+   cgOut.AllPol();
+   ceOut.AllPol();
+
+   // Bremsstrahlung of an 8.7 GeV photon by a 12 GeV electron
+   TLepton beIn(mElectron), beOut(mElectron);
+   TPhoton bgOut;
+   const LDouble_t pBrems = 12;
+   beIn.SetMom(pBrems * zhat);
+   TThreeVectorReal qBrems(Bench_recoil(beIn.Mom()[0], pBrems, 2e-3, 1e-7));
+   Bench_decay(beIn.Mom() - TFourVectorReal(0, qBrems), 0, mElectron,
+               0.2, 0.3, p1, p2);
+   bgOut.SetMom(p1);
+   beOut.SetMom(p2);
+   beIn.SetPol(unpol);
+   bgOut.AllPol();
+   beOut.AllPol();
+
+   // Coherent pair production by a 9 GeV photon, as in demoPairs
+   TPhoton pgIn;
+   TLepton peOut(mElectron), ppOut(mElectron);
+   const LDouble_t kin = 9;
+   pgIn.SetMom(kin * zhat);
+   TThreeVectorReal qPairs(Bench_recoil(kin, kin, 2e-3, 1e-6));
+   Bench_decay(pgIn.Mom() - TFourVectorReal(0, qPairs), mElectron, mElectron,
+               0.1, PI_/2, p1, p2);
+   ppOut.SetMom(p1);
+   peOut.SetMom(p2);
+   pgIn.SetPol(TThreeVectorReal(1, 0, 0));
+   peOut.AllPol();
+   ppOut.AllPol();
+
+   // Triplet production by a 9 GeV photon, as in demoTriplets
+   TPhoton tgIn;
+   TLepton teIn(mElectron), tpOut(mElectron), teOut2(mElectron),
+           teOut3(mElectron);
+   tgIn.SetMom(kin * zhat);
+   teIn.SetMom(eRest);
+   Bench_decay(tgIn.Mom() + eRest, 2e-3, mElectron, 0.9, 0.3, p12, p3);
+   Bench_decay(p12, mElectron, mElectron, 0.1, PI_/2, p1, p2);
+   tpOut.SetMom(p1);
+   teOut2.SetMom(p2);
+   teOut3.SetMom(p3);
+   tgIn.SetPol(TThreeVectorReal(1, 0, 0));
+   teIn.SetPol(unpol);
+   tpOut.AllPol();
+   teOut2.AllPol();
+   teOut3.AllPol();
+
+   // Bethe-Heitler pair production by a 9 GeV photon on a free proton
+   TPhoton hgIn;
+   TLepton hnIn(mProton), hpOut(mElectron), heOut(mElectron),
+           hnOut(mProton);
+   hgIn.SetMom(kin * zhat);
+   hnIn.SetMom(pRest);
+   Bench_decay(hgIn.Mom() + pRest, 2e-3, mProton, 0.999, 0.3, p12, p3);
+   Bench_decay(p12, mElectron, mElectron, 0.1, PI_/2, p1, p2);
+   hpOut.SetMom(p1);
+   heOut.SetMom(p2);
+   hnOut.SetMom(p3);
+   hgIn.SetPol(TThreeVectorReal(1, 0, 0));
+   hnIn.SetPol(unpol);
+   hpOut.AllPol();
+   heOut.AllPol();
+   hnOut.AllPol();
+
+   // e-e- bremsstrahlung by a 12 GeV electron on a free electron
+   TLepton eeIn0(mElectron), eeIn1(mElectron), eeOut2(mElectron),
+           eeOut3(mElectron);
+   TPhoton eegOut;
+   eeIn0.SetMom(pBrems * zhat);
+   eeIn1.SetMom(eRest);
+   Bench_decay(eeIn0.Mom() + eRest, 0, 0.05, 0.2, 0.3, p1, p2);
+   eegOut.SetMom(p1);
+   Bench_decay(p2, mElectron, mElectron, 0.9, 0.3, p3, p4);
+   eeOut2.SetMom(p3);
+   eeOut3.SetMom(p4);
+   eeIn0.SetPol(unpol);
+   eeIn1.SetPol(unpol);
+   eegOut.AllPol();
+   eeOut2.AllPol();
+   eeOut3.AllPol();
+
+   // Electroproduction of a pair by a 12 GeV electron on an atom
+   TLepton xeIn(mElectron), xeOut(mElectron), xlpOut(mElectron),
+           xlnOut(mElectron);
+   xeIn.SetMom(pBrems * zhat);
+   TThreeVectorReal qElectro(Bench_recoil(xeIn.Mom()[0], pBrems,
+                                          1e-2, 1e-6));
+   Bench_decay(xeIn.Mom() - TFourVectorReal(0, qElectro), mElectron, 2e-3,
+               0.2, 0.3, p1, p12);
+   Bench_decay(p12, mElectron, mElectron, 0.1, PI_/2, p2, p3);
+   xeOut.SetMom(p1);
+   xlpOut.SetMom(p2);
+   xlnOut.SetMom(p3);
+   xeIn.SetPol(unpol);
+   xeOut.AllPol();
+   xlpOut.AllPol();
+   xlnOut.AllPol();
+
+   // Electroproduction of a pair by a 12 GeV electron on a free electron
+   TLepton yeIn(mElectron), yeOut(mElectron), ylpOut(mElectron),
+           ylnOut(mElectron), yteIn(mElectron), yteOut(mElectron);
+   yeIn.SetMom(pBrems * zhat);
+   yteIn.SetMom(eRest);
+   Bench_decay(yeIn.Mom() + eRest, mElectron, 0.05, 0.9, 0.3, p4, p123);
+   Bench_decay(p123, mElectron, 2e-3, 0.2, 0.3, p1, p12);
+   Bench_decay(p12, mElectron, mElectron, 0.1, PI_/2, p2, p3);
+   yteOut.SetMom(p4);
+   yeOut.SetMom(p1);
+   ylpOut.SetMom(p2);
+   ylnOut.SetMom(p3);
+   yeIn.SetPol(unpol);
+   yteIn.SetPol(unpol);
+   yeOut.AllPol();
+   ylpOut.AllPol();
+   ylnOut.AllPol();
+   yteOut.AllPol();
+
+   TAmplitudeTensor amp;
+   struct {
+      const char *name;
+      std::function<void()> func;
+   } bench[] = {
+      {"TCrossSection::Compton",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::Compton(cgIn, ceIn, cgOut, ceOut); }},
+      {"TCrossSection::ComptonAmplitude",
+       [&]() { TCrossSection::ComptonAmplitude(cgIn, ceIn, cgOut, ceOut, amp);
+               Bench_sink += (Double_t)amp.KinFactor(); }},
+      {"TCrossSection::Bremsstrahlung",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::Bremsstrahlung(beIn, beOut, bgOut); }},
+      {"TCrossSection::BremsstrahlungAmplitude",
+       [&]() { TCrossSection::BremsstrahlungAmplitude(beIn, beOut, bgOut, amp);
+               Bench_sink += (Double_t)amp.KinFactor(); }},
+      {"TCrossSection::PairProduction",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::PairProduction(pgIn, peOut, ppOut); }},
+      {"TCrossSection::PairProductionAmplitude",
+       [&]() { TCrossSection::PairProductionAmplitude(pgIn, peOut, ppOut, amp);
+               Bench_sink += (Double_t)amp.KinFactor(); }},
+      {"TCrossSection::TripletProduction",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::TripletProduction(tgIn, teIn, tpOut,
+                                                teOut2, teOut3); }},
+      {"TCrossSection::TripletProductionAmplitude",
+       [&]() { TCrossSection::TripletProductionAmplitude(tgIn, teIn, tpOut,
+                                                         teOut2, teOut3, amp);
+               Bench_sink += (Double_t)amp.KinFactor(); }},
+      {"TCrossSection::BetheHeitlerNucleon",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::BetheHeitlerNucleon(hgIn, hnIn, hpOut, heOut,
+                                                  hnOut, 1, 0, 1, 0); }},
+      {"TCrossSection::eeBremsstrahlung",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::eeBremsstrahlung(eeIn0, eeIn1, eeOut2, eeOut3,
+                                               eegOut); }},
+      {"TCrossSection::ePairProduction",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::ePairProduction(xeIn, xeOut, xlpOut, xlnOut); }},
+      {"TCrossSection::ePairProductionAmplitude",
+       [&]() { TCrossSection::ePairProductionAmplitude(xeIn, xeOut, xlpOut,
+                                                       xlnOut, amp);
+               Bench_sink += (Double_t)amp.KinFactor(); }},
+      {"TCrossSection::eTripletProduction",
+       [&]() { Bench_sink += (Double_t)
+               TCrossSection::eTripletProduction(yeIn, yeOut, ylpOut, ylnOut,
+                                                 yteIn, yteOut); }}
+   };
+   for (auto &b : bench) {
+      if (std::string(b.name).find(filter) == std::string::npos)
+         continue;
+      results.push_back(Bench_time("process", b.name, seconds, b.func));
+   }
+}
+
+void Bench_kernels(Double_t seconds, const std::string &filter,
+                   std::vector<Bench_result_t> &results)
+{
+   // Times the Dirac algebra and Lorentz kinematics operations out of
+   // which the amplitudes are built, on the momenta of the pair
+   // production benchmark above.
+
+   const LDouble_t kin = 9;
+   TFourVectorReal p1, p2;
+   Bench_decay(TFourVectorReal(kin, 1e-3, 0, kin - 2e-7), mElectron, mElectron,
+               0.1, PI_/2, p1, p2);
+   TFourVectorReal eps(0, 1, 0, 0);
+   TDiracMatrix a, b, c;
+   a.Slash(p1);
+   b.Slash(p2);
+   TDiracSpinor u, v;
+   u.SetStateU(p1, +0.5);
+   v.SetStateU(p2, -0.5);
+   TLorentzBoost boost(p1);
+   TLorentzBoost toRest(p1);
+   toRest.Invert();
+   TDiracMatrix d(a);
+   d += TDiracMatrix(kDiracGamma0);
+
+   // amplitude tensor with all 5 legs of triplet production, contracted
+   // with unpolarized initial and spin-summed final states
+   TAmplitudeTensor amp(5, (1 << 2) + (1 << 3) + (1 << 4));
+   for (Int_t i=0; i < amp.Size(); i++)
+      amp[i] = Complex_t(i + 1, 5 - i);
+   amp.SetKinFactor(1);
+   TPauliMatrix unpol;
+   unpol.SetDiagonal(Complex_t(0.5));
+   const TPauliMatrix *sdm[5] = {&unpol, &unpol, 0, 0, 0};
+
+   struct {
+      const char *name;
+      std::function<void()> func;
+   } bench[] = {
+      {"TDiracMatrix::operator*(TDiracMatrix)",
+       [&]() { c = a * b; Bench_sink += (Double_t)real(c[0][0]); }},
+      {"TDiracMatrix::operator*=(TDiracMatrix)",
+       [&]() { c = a; c *= b; Bench_sink += (Double_t)real(c[0][0]); }},
+      {"TDiracMatrix*TDiracSpinor",
+       [&]() { v = a * u; Bench_sink += (Double_t)real(v[0]); }},
+      {"TDiracMatrix::Slash(TFourVectorReal)",
+       [&]() { c.Slash(p1); Bench_sink += (Double_t)real(c[0][0]); }},
+      {"TDiracMatrix::SetUUbar(p)",
+       [&]() { c.SetUUbar(p1); Bench_sink += (Double_t)real(c[0][0]); }},
+      {"TDiracMatrix::SetBoost(TLorentzBoost)",
+       [&]() { c.SetBoost(boost); Bench_sink += (Double_t)real(c[0][0]); }},
+      {"TDiracMatrix::Determ()",
+       [&]() { Bench_sink += (Double_t)real(d.Determ()); }},
+      {"TDiracMatrix::Invert()",
+       [&]() { c = d; c.Invert(); Bench_sink += (Double_t)real(c[0][0]); }},
+      {"TDiracSpinor::SetStateU(p,helicity)",
+       [&]() { v.SetStateU(p1, +0.5); Bench_sink += (Double_t)real(v[0]); }},
+      {"TDiracSpinor::ScalarProd(TDiracSpinor)",
+       [&]() { Bench_sink += (Double_t)real(u.ScalarProd(v)); }},
+      {"TFourVectorReal::ScalarProd(TFourVectorReal)",
+       [&]() { Bench_sink += (Double_t)p1.ScalarProd(p2); }},
+      {"TLorentzBoost::SetBeta(TFourVectorReal)",
+       [&]() { boost.SetBeta(p1); }},
+      {"TFourVectorReal::Boost(TLorentzBoost)",
+       [&]() { TFourVectorReal p(p2); p.Boost(toRest);
+               Bench_sink += (Double_t)p[0]; }},
+      {"TDiracSpinor::Boost(TLorentzBoost)",
+       [&]() { TDiracSpinor w(u); w.Boost(toRest);
+               Bench_sink += (Double_t)real(w[0]); }},
+      {"TAmplitudeTensor::Contract(5 legs)",
+       [&]() { Bench_sink += (Double_t)amp.Contract(sdm); }}
+   };
+   for (auto &b : bench) {
+      if (std::string(b.name).find(filter) == std::string::npos)
+         continue;
+      results.push_back(Bench_time("kernel", b.name, seconds, b.func));
+   }
+}
+
+void Bench_pipelines(Double_t seconds, const std::string &filter,
+                     std::vector<Bench_result_t> &results)
+{
+   // Times the hand-off of blocks of events between the stages of the
+   // generators, with the events themselves reduced to a few random
+   // numbers, so that any allocation per block would show up.
+
+   const Int_t chunk = 1024;
+   Stream_t<Double_t> stream(
+      [](Double_t *events, Int_t n, TRandom &random_gen) {
+         for (Int_t i=0; i < n; i++)
+            events[i] = random_gen.Uniform(1);
+         return n;
+      }, chunk, -1, 2, 4, 1);
+
+   struct {
+      const char *name;
+      std::function<void()> func;
+   } bench[] = {
+      {"Stream_t::Next+Recycle(1024 events)",
+       [&]() { Double_t *events = stream.Next();
+               Bench_sink += events[chunk - 1];
+               stream.Recycle(events); }},
+      {"Batch_vectors_t(1024 events)",
+       [&]() { Batch_vectors_t mom(chunk);
+               Bench_sink += mom(chunk - 1, 3); }}
+   };
+   for (auto &b : bench) {
+      if (std::string(b.name).find(filter) == std::string::npos)
+         continue;
+      results.push_back(Bench_time("pipeline", b.name, seconds, b.func));
+   }
+}
+
+std::string Bench_compiler()
+{
+#if defined __clang__
+   return std::string("clang ") + __clang_version__;
+#elif defined __GNUC__
+   return std::string("gcc ") + __VERSION__;
+#else
+   return "unknown";
+#endif
+}
+
+std::string Bench_quote(const std::string &s)
+{
+   // Returns s as a JSON string literal.
+
+   std::string q("\"");
+   for (UInt_t i=0; i < s.size(); i++) {
+      if (s[i] == '"' || s[i] == '\\')
+         q += '\\';
+      if ((unsigned char)s[i] >= ' ')
+         q += s[i];
+   }
+   return q + "\"";
+}
+
+std::string Bench_number(Double_t x)
+{
+   // Returns x formatted as a JSON number, or null if x is negative,
+   // meaning that it is not available.
+
+   if (x < 0)
+      return "null";
+   std::ostringstream str;
+   str.precision(6);
+   str << x;
+   return str.str();
+}
+
+void Bench_write(std::ostream &out, const std::vector<Bench_result_t> &results,
+                 Double_t seconds)
+{
+   char hostname[256] = "unknown";
+   gethostname(hostname, sizeof(hostname) - 1);
+   char date[32];
+   time_t now = time(0);
+   strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+   out << "{" << std::endl
+       << "  \"package\": \"Dirac++\"," << std::endl
+       << "  \"date\": " << Bench_quote(date) << "," << std::endl
+       << "  \"host\": " << Bench_quote(hostname) << "," << std::endl
+       << "  \"cpu\": " << Bench_quote(Bench_cpu()) << "," << std::endl
+       << "  \"hardware_threads\": "
+       << std::thread::hardware_concurrency() << "," << std::endl
+       << "  \"compiler\": " << Bench_quote(Bench_compiler()) << ","
+       << std::endl
+       << "  \"cplusplus\": " << __cplusplus << "," << std::endl
+#if defined __OPTIMIZE__
+       << "  \"optimized\": true," << std::endl
+#else
+       << "  \"optimized\": false," << std::endl
+#endif
+       << "  \"scalar_type\": " << Bench_quote(Bench_build) << ","
+       << std::endl
+       << "  \"validation_rate\": " << Bench_validation << "," << std::endl
+       << "  \"seconds_per_benchmark\": " << seconds << "," << std::endl
+       << "  \"rounds\": " << Bench_rounds << "," << std::endl
+       << "  \"perf_counters\": {";
+   for (Int_t c=0; c < kBenchCounters; c++) {
+      out << ((c > 0)? ", " : "") << "\"" << Bench_counter_names[c] << "\": "
+          << ((Bench_perf.Available(c))? "true" : "false");
+   }
+   char fpEvent[32];
+   snprintf(fpEvent, sizeof(fpEvent), "0x%04llx", Bench_perf.FPEvent());
+   out << ", \"fp_event\": " << Bench_quote(fpEvent) << "}," << std::endl
+       << "  \"benchmarks\": [" << std::endl;
+   out.precision(6);
+   for (UInt_t i=0; i < results.size(); i++) {
+      const Bench_result_t &r = results[i];
+      out << "    {\"name\": " << Bench_quote(r.name)
+          << ", \"group\": " << Bench_quote(r.group)
+          << ", \"ns_per_call\": " << r.nsPerCall
+          << ", \"ns_per_call_min\": " << r.nsPerCallMin
+          << ", \"calls_per_s\": " << 1e9 / r.nsPerCall
+          << ", \"calls_per_round\": " << r.calls
+          << ", \"allocations_per_call\": " << r.allocations;
+      for (Int_t c=0; c < kBenchCounters; c++) {
+         out << ", \"" << Bench_counter_names[c] << "_per_call\": "
+             << Bench_number(r.counts[c]);
+      }
+      const Double_t *n = r.counts;
+      out << ", \"ipc\": "
+          << Bench_number((n[kBenchCycles] > 0 && n[kBenchInstructions] >= 0)?
+                          n[kBenchInstructions] / n[kBenchCycles] : -1)
+          << ", \"gflops\": "
+          << Bench_number((n[kBenchFPOps] >= 0)?
+                          n[kBenchFPOps] / r.nsPerCall : -1)
+          << "}" << ((i + 1 < results.size())? "," : "") << std::endl;
+   }
+   out << "  ]" << std::endl
+       << "}" << std::endl;
+}
+
+Int_t main(Int_t argc, char *argv[])
+{
+   std::string outfile = (argc > 1)? argv[1] : "-";
+   Double_t seconds = (argc > 2)? atof(argv[2]) : 0.5;
+   std::string filter = (argc > 3)? argv[3] : "";
+   if (seconds <= 0) {
+      std::cerr << "usage: " << argv[0]
+                << " [output file] [seconds per benchmark] [name filter]"
+                << std::endl;
+      return 1;
+   }
+
+   Int_t ncounters = 0;
+   for (Int_t c=0; c < kBenchCounters; c++)
+      ncounters += Bench_perf.Available(c);
+   if (ncounters == 0) {
+      std::cerr << "hardware performance counters are not available, "
+                << "reporting times only" << std::endl;
+   }
+
+   const char *validation = getenv("BENCH_VALIDATION");
+   Bench_validation = (validation)? atof(validation) : 0;
+   TCrossSection::SetValidation(Bench_validation);
+
+   std::vector<Bench_result_t> results;
+   Bench_processes(seconds, filter, results);
+   Bench_kernels(seconds, filter, results);
+   Bench_pipelines(seconds, filter, results);
+
+   Int_t allocating = 0;
+   for (UInt_t i=0; i < results.size(); i++) {
+      if (results[i].allocations > 0) {
+         std::cerr << "error: " << results[i].name << " makes "
+                   << results[i].allocations << " heap allocations per call"
+                   << std::endl;
+         ++allocating;
+      }
+   }
+
+   if (outfile == "-") {
+      Bench_write(std::cout, results, seconds);
+   }
+   else {
+      std::ofstream out(outfile.c_str());
+      Bench_write(out, results, seconds);
+      if (!out) {
+         std::cerr << "error writing " << outfile << std::endl;
+         return 1;
+      }
+      std::cerr << "saved " << results.size() << " results to "
+                << outfile << std::endl;
+   }
+   return (allocating > 0)? 2 : 0;
+}
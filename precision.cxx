@@ -0,0 +1,316 @@
+//
+// precision.cxx
+//
+// Compares the accuracy and throughput of the package built with each
+// of its scalar types for LDouble_t (see Double.h) on the kinematics
+// sampled by the Pairs.C and Triplets.C generators.  The program is
+// built from this file once for each scalar type, as precision_qd for
+// the quad-precision reference QDouble_t, precision_ld for the standard
+// long double, precision_dd for the double-double DDouble_t and
+// precision_d for plain double (see Makefile).
+//
+// usage: precision_qd|precision_ld|precision_dd|precision_d <points file> [N]
+//        precision_d <points file> -escalate <tolerance> <escalation file>
+//        precision_ld|precision_qd <points file> -escalate <escalation file>
+//
+// If the points file does not exist, N points are sampled from the pair
+// and triplet phase space, the polarized cross sections are evaluated at
+// each one, and the points and results are saved in the file.  If it
+// does exist, the cross sections are evaluated at the points saved in
+// the file, and the distribution of the relative differences from the
+// saved results is printed.  Either way the time per call is printed.
+// Running precision_qd first to create the file, and then the others
+// on the same file, gives the errors of the faster builds with respect
+// to the quad-precision reference.  The sampled points include
+// the collinear region at small recoil momentum, where the rounding
+// errors are largest.
+//
+// The -escalate options run the adaptive precision mode in two passes.
+// Two builds with different scalar types cannot be linked into the same
+// program, so the events are passed from one to the other in a file.  In
+// the first pass, precision_d evaluates every point in double with the
+// escalation checks turned on (see TCrossSection::SetEscalation), and
+// saves its results, with the points flagged for escalation, in the
+// escalation file.  Points where the kinematics could not be solved in
+// double are flagged as well.  In the second pass precision_ld or
+// precision_qd recomputes only the flagged points, and prints the errors
+// of the merged results and the time per call of the two passes together.
+//
+// author: richard.t.jones at uconn.edu
+// version: october 18, 2026
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "TPhoton.h"
+#include "TLepton.h"
+#include "TAmplitudeTensor.h"
+#include "TCrossSection.h"
+#include "constants.h"
+#include "Generators.h"
+
+#include <TRandom2.h>
+
+struct Precision_point_t {
+   Double_t pairs[6];          // par[0..5] passed to PairsPolarized
+   Double_t triplets[6];       // par[0..5] passed to TripletsPolarized
+   Double_t result[2][2];      // pairs,triplets cross sections as hi,lo
+};
+
+struct Precision_escalation_t {
+   Double_t result[2];         // first pass pairs,triplets cross sections
+   Int_t flagged[2];           // nonzero if to be recomputed
+};
+
+#if defined DIRACXX_DOUBLE_DOUBLE
+const char *Precision_build = "double-double";
+#elif defined DIRACXX_FLOAT128
+const char *Precision_build = "quad precision";
+#elif defined DIRACXX_DOUBLE
+const char *Precision_build = "double";
+#else
+const char *Precision_build = "long double";
+#endif
+
+void Precision_sample(Int_t N, std::vector<Precision_point_t> &points)
+{
+   // Samples N points from the pair and triplet production phase space
+   // for a 9 GeV photon, keeping only those with non-zero cross section.
+
+   TRandom2 random_gen(1);
+   points.resize(N);
+   for (Int_t n=0; n < N; n++) {
+      Precision_point_t &point = points[n];
+      point.pairs[0] = 9.0;
+      point.triplets[0] = 9.0;
+      Double_t urand[5];
+      do {
+         PairsSample(point.pairs[0], random_gen, &point.pairs[1]);
+         random_gen.RndmArray(5, urand);
+         TripletsSample(point.triplets[0], urand, &point.triplets[1]);
+      } while (PairsPolarized(&point.pairs[1], point.pairs,
+                              TThreeVectorReal(1,0,0)) == 0 ||
+               TripletsPolarized(&point.triplets[1], point.triplets,
+                                 TThreeVectorReal(1,0,0)) == 0);
+   }
+}
+
+Double_t Precision_evaluate(std::vector<Precision_point_t> &points,
+                            Int_t process, std::vector<LDouble_t> &result,
+                            std::vector<Precision_escalation_t> *escalation=0,
+                            Bool_t check=0)
+{
+   // Evaluates the cross sections for process 0=pairs, 1=triplets at all
+   // of the points, and returns the total time taken in us.  The
+   // results are obtained by contracting the amplitudes returned by
+   // PairsPolarized and TripletsPolarized, so that they keep the full
+   // precision of LDouble_t.  If escalation is given, the points are
+   // marked in it that are flagged by the escalation checks if check is
+   // set, or else only the points already marked in it are evaluated.
+
+   const TThreeVectorReal pol(1,0,0);
+   TPhoton gIn;
+   gIn.SetPol(pol);
+   TLepton eIn;
+   eIn.SetPol(TThreeVectorReal(0,0,0));
+   const TPauliMatrix *sdm[5] = {&gIn.SDM(), &eIn.SDM(), 0, 0, 0};
+   result.resize(points.size());
+   auto start = std::chrono::steady_clock::now();
+   for (UInt_t n=0; n < points.size(); n++) {
+      if (escalation && !check && !(*escalation)[n].flagged[process])
+         continue;
+      TAmplitudeTensor amp;
+      if (process == 0) {
+         PairsPolarized(&points[n].pairs[1], points[n].pairs, pol,
+                        0, 0, &amp);
+         sdm[1] = 0;
+      }
+      else {
+         TripletsPolarized(&points[n].triplets[1], points[n].triplets, pol,
+                           0, 0, &amp);
+         sdm[1] = &eIn.SDM();
+      }
+      result[n] = (amp.Legs() > 0)? amp.Contract(sdm) : (LDouble_t)0;
+      if (escalation && check) {
+         (*escalation)[n].flagged[process] = (amp.Legs() == 0) ||
+                                     TCrossSection::Escalate(amp, sdm);
+      }
+   }
+   auto stop = std::chrono::steady_clock::now();
+   return std::chrono::duration<Double_t, std::micro>(stop - start).count();
+}
+
+void Precision_compare(std::vector<Precision_point_t> &points,
+                       Int_t process, std::vector<LDouble_t> &result,
+                       const std::vector<Precision_escalation_t> *skip=0)
+{
+   // Prints the distribution of the relative differences of result from
+   // the saved results for process 0=pairs, 1=triplets, by decade from
+   // 1e-32 to 1, together with the largest one and the recoil momentum
+   // squared of the point where it occurs.  The points flagged in skip,
+   // if given, are left out.
+
+   const Int_t ndecades = 32;
+   Int_t counts[ndecades + 1] = {0};
+   LDouble_t maxdiff = 0;
+   Int_t maxpoint = 0;
+   for (UInt_t n=0; n < points.size(); n++) {
+      if (skip && (*skip)[n].flagged[process])
+         continue;
+      LDouble_t saved = points[n].result[process][0];
+      saved += points[n].result[process][1];
+      LDouble_t diff = (saved != 0)? fabs(result[n]/saved - 1) : (LDouble_t)0;
+      if (diff > maxdiff) {
+         maxdiff = diff;
+         maxpoint = n;
+      }
+      Int_t decade = 0;
+      for (LDouble_t limit=1e-32; diff > limit && decade < ndecades;
+           limit *= 10)
+      {
+         ++decade;
+      }
+      ++counts[decade];
+   }
+   const Double_t *par = (process == 0)? points[maxpoint].pairs :
+                                         points[maxpoint].triplets;
+   std::cout << "  relative difference from saved results, max "
+             << maxdiff << " at qR^2 = " << par[4] << " GeV^2" << std::endl;
+   for (Int_t d=0; d <= ndecades; d++) {
+      if (counts[d] > 0)
+         std::cout << "    < 1e" << d - ndecades << " : "
+                   << counts[d] << std::endl;
+   }
+}
+
+Int_t main(Int_t argc, char *argv[])
+{
+   // The escalation file holds the times per call of the first pass for
+   // pairs and triplets, followed by one Precision_escalation_t per point.
+
+   Bool_t escalate = (argc > 2 && strcmp(argv[2], "-escalate") == 0);
+   Bool_t firstPass = escalate && argc > 4;
+   if (argc < 2 || (escalate && argc < 4)) {
+      std::cerr << "usage: " << argv[0] << " <points file> [N]" << std::endl
+                << "       " << argv[0] << " <points file> -escalate"
+                << " [<tolerance>] <escalation file>" << std::endl;
+      return 1;
+   }
+   Int_t N = (argc > 2 && !escalate)? atoi(argv[2]) : 10000;
+   std::vector<Precision_point_t> points;
+   FILE *fp = fopen(argv[1], "rb");
+   Bool_t compare = (fp != 0);
+   if (compare) {
+      Precision_point_t point;
+      while (fread(&point, sizeof(point), 1, fp) == 1)
+         points.push_back(point);
+      fclose(fp);
+      std::cout << "read " << points.size() << " points from "
+                << argv[1] << std::endl;
+   }
+   else if (escalate) {
+      std::cerr << "points file " << argv[1] << " not found" << std::endl;
+      return 1;
+   }
+   else {
+      Precision_sample(N, points);
+   }
+
+   const char *escfile = argv[argc - 1];
+   Double_t firstUs[2] = {0, 0};
+   std::vector<Precision_escalation_t> escalation(points.size());
+   if (firstPass) {
+      TCrossSection::SetEscalation(atof(argv[3]));
+   }
+   else if (escalate) {
+      fp = fopen(escfile, "rb");
+      if (fp == 0 || fread(firstUs, sizeof(firstUs), 1, fp) != 1 ||
+          fread(&escalation[0], sizeof(Precision_escalation_t),
+                points.size(), fp) != points.size())
+      {
+         std::cerr << "error reading escalation file " << escfile
+                   << std::endl;
+         return 1;
+      }
+      fclose(fp);
+   }
+
+   std::cout << Precision_build << " build" << std::endl;
+   const char *process[2] = {"pairs", "triplets"};
+   for (Int_t p=0; p < 2; p++) {
+      std::vector<LDouble_t> result;
+      Double_t us = Precision_evaluate(points, p, result,
+                                       (escalate)? &escalation : 0,
+                                       firstPass);
+      Int_t nflagged = 0;
+      for (UInt_t n=0; n < points.size(); n++) {
+         if (escalate && escalation[n].flagged[p]) {
+            ++nflagged;
+         }
+         else if (escalate && !firstPass) {
+            result[n] = escalation[n].result[p];
+         }
+         if (firstPass)
+            escalation[n].result[p] = (Double_t)result[n];
+      }
+      Double_t usPerCall = us / points.size();
+      std::cout << process[p] << ", " << Precision_build << ": "
+                << std::setprecision(4) << usPerCall << " us/call";
+      if (escalate) {
+         std::cout << ", " << nflagged << " of " << points.size()
+                   << " points " << ((firstPass)? "flagged" : "recomputed");
+      }
+      if (escalate && !firstPass) {
+         std::cout << ", " << firstUs[p] + usPerCall
+                   << " us/call for both passes";
+      }
+      std::cout << std::endl;
+      if (firstPass)
+         firstUs[p] = usPerCall;
+      if (compare) {
+         Precision_compare(points, p, result,
+                           (firstPass)? &escalation : 0);
+      }
+      else {
+         for (UInt_t n=0; n < points.size(); n++) {
+            points[n].result[p][0] = (Double_t)result[n];
+            points[n].result[p][1] = (Double_t)(result[n] -
+                                                points[n].result[p][0]);
+         }
+      }
+   }
+
+   if (firstPass) {
+      TCrossSection::PrintDiagnostics(0);
+      fp = fopen(escfile, "wb");
+      if (fp == 0 || fwrite(firstUs, sizeof(firstUs), 1, fp) != 1 ||
+          fwrite(&escalation[0], sizeof(Precision_escalation_t),
+                 points.size(), fp) != points.size())
+      {
+         std::cerr << "error writing escalation file " << escfile
+                   << std::endl;
+         return 1;
+      }
+      fclose(fp);
+      std::cout << "saved the first pass results to " << escfile
+                << std::endl;
+   }
+   if (!compare) {
+      fp = fopen(argv[1], "wb");
+      if (fp == 0 || fwrite(&points[0], sizeof(Precision_point_t),
+                            points.size(), fp) != points.size())
+      {
+         std::cerr << "error writing points file " << argv[1] << std::endl;
+         return 1;
+      }
+      fclose(fp);
+      std::cout << "saved " << points.size() << " points to "
+                << argv[1] << std::endl;
+   }
+   return 0;
+}
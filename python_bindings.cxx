@@ -6,9 +6,17 @@
 // version: (still under construction)
 
 #include <boost/python.hpp>
+#include <boost/python/numpy.hpp>
 
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstddef>
+
+#include <Batch.h>
 #include <Double.h>
 #include <Complex.h>
+#include <TAmplitudeTensor.h>
 #include <TCrossSection.h>
 #include <TDiracMatrix.h>
 #include <TDiracSpinor.h>
@@ -24,6 +32,76 @@
 #include <TThreeVectorComplex.h>
 #include <TThreeVectorReal.h>
 #include <constants.h>
+#include <Stream.h>
+#include <Pickle.h>
+#include <Generators.h>
+
+namespace np = boost::python::numpy;
+
+// The compute-heavy methods, the cross sections of TCrossSection, the
+// products and inverses of TDiracMatrix and TLorentzTransform, and the
+// boosts of the vectors, spinors and Dirac matrices, release the python
+// global interpreter lock while they run, so that python threads calling
+// them at the same time run in parallel.  The TCrossSection methods keep
+// their counters and diagnostics per thread or in atomics, so they may
+// be called from any number of threads at once.  The value objects
+// (vectors, spinors, matrices, transforms, leptons and photons) are not
+// locked: an object may be shared between threads as long as none of
+// them modifies it, for example the fixed beam and target legs passed
+// to the cross sections, but an object that is being modified in place
+// by one thread, by Boost, SetMom, *= and the like, must not be used by
+// any other thread at the same time.  SetResolution sets a value shared
+// by all objects of the class, and should only be called before the
+// threads are started.
+
+class Python_nogil_t {
+
+   // Releases the python global interpreter lock for the lifetime of
+   // the object, for computations that do not touch python objects.
+
+public:
+   Python_nogil_t() : fState(PyEval_SaveThread()) { }
+   ~Python_nogil_t() { PyEval_RestoreThread(fState); }
+
+private:
+   PyThreadState *fState;
+};
+
+template <class F, F func>
+struct Python_nogil_call;
+
+// Python_nogil_call<F, func>::call is a function with the same arguments
+// as func, with the object as the first argument for methods, that calls
+// func with the global interpreter lock released.  It is used through
+// DIRACXX_NOGIL(ptr, func), where ptr is any expression with the pointer
+// type of func, such as the pointers declared above to pick one overload.
+
+template <class R, class... A, R (*func)(A...)>
+struct Python_nogil_call<R (*)(A...), func> {
+   static R call(A... args) {
+      Python_nogil_t nogil;
+      return func(args...);
+   }
+};
+
+template <class C, class R, class... A, R (C::*func)(A...)>
+struct Python_nogil_call<R (C::*)(A...), func> {
+   static R call(C &obj, A... args) {
+      Python_nogil_t nogil;
+      return (obj.*func)(args...);
+   }
+};
+
+template <class C, class R, class... A, R (C::*func)(A...) const>
+struct Python_nogil_call<R (C::*)(A...) const, func> {
+   static R call(const C &obj, A... args) {
+      Python_nogil_t nogil;
+      return (obj.*func)(args...);
+   }
+};
+
+#define DIRACXX_NOGIL(ptr, func) \
+   (&Python_nogil_call<decltype(ptr), func>::call)
 
 Complex_t Complex_abs(const Complex_t val) {
    return std::abs(val);
@@ -208,6 +286,18 @@ void TLorentzTransform_Print(TLorentzTransform &obj) {
    obj.Print();
 }
 
+TLorentzTransform TLorentzTransform_mul(const TLorentzTransform &a,
+                                        const TLorentzTransform &b) {
+   Python_nogil_t nogil;
+   return a * b;
+}
+
+TLorentzTransform &TLorentzTransform_imul(TLorentzTransform &a,
+                                          const TLorentzTransform &b) {
+   Python_nogil_t nogil;
+   return a *= b;
+}
+
 
 Complex_t *TPauliMatrix_getitem(const TPauliMatrix &obj, Int_t index) {
    return obj[index];
@@ -304,6 +394,26 @@ void TDiracMatrix_Print(TDiracMatrix &obj) {
    obj.Print();
 }
 
+TDiracMatrix TDiracMatrix_mul(const TDiracMatrix &a, const TDiracMatrix &b) {
+   Python_nogil_t nogil;
+   return a * b;
+}
+
+TDiracMatrix TDiracMatrix_div(const TDiracMatrix &a, const TDiracMatrix &b) {
+   Python_nogil_t nogil;
+   return a / b;
+}
+
+TDiracMatrix &TDiracMatrix_imul(TDiracMatrix &a, const TDiracMatrix &b) {
+   Python_nogil_t nogil;
+   return a *= b;
+}
+
+TDiracMatrix &TDiracMatrix_idiv(TDiracMatrix &a, const TDiracMatrix &b) {
+   Python_nogil_t nogil;
+   return a /= b;
+}
+
 
 Complex_t &TPauliSpinor_getitem(const TPauliSpinor &obj, int index) {
    return obj[index];
@@ -426,6 +536,895 @@ void TCrossSection_Print(TCrossSection &obj) {
    obj.Print();
 }
 
+// Array versions of the TCrossSection methods, which take the momenta
+// of each leg as a NumPy array of shape (N,4), or (4,) for a momentum
+// that is the same in all N events, and return the N cross sections as
+// a NumPy array, see Batch.h.  A leg may also be given as a tuple
+// (mom, pol) or (mom, pol, mass), with pol an array of shape (N,3) or
+// (3,) of polarization vectors in the encoding of SetPol, or None for
+// unpolarized initial and summed final states, and mass overriding the
+// default mass of the leg.  The python global interpreter lock is
+// released while the cross sections are computed, by the scalar
+// TCrossSection methods called for each event in nthreads parallel
+// ranges on the shared worker pool of Pool.h, not by SIMD kernels.
+
+void Python_value_error(const std::string &message) {
+   PyErr_SetString(PyExc_ValueError, message.c_str());
+   boost::python::throw_error_already_set();
+}
+
+np::ndarray Batch_ndarray(boost::python::object obj, Int_t ncols,
+                          Long64_t &nevents, const Double_t *&data,
+                          Long64_t &row, Long64_t &col,
+                          const std::string &what)
+{
+   // Converts obj to an array of doubles of shape (N,ncols) or (ncols,),
+   // without copying if it already is one, and returns its data pointer
+   // and strides in units of doubles, with row=0 for a single row.  The
+   // number of rows is checked against nevents, or sets it if nevents
+   // is still unknown (-1).  The returned array holds the data.
+
+   np::ndarray array = np::from_object(obj,
+                       np::dtype::get_builtin<Double_t>(),
+                       np::ndarray::ALIGNED);
+   Int_t ndim = array.get_nd();
+   const Py_intptr_t *shape = array.get_shape();
+   const Py_intptr_t *strides = array.get_strides();
+   if (ndim < 1 || ndim > 2 || shape[ndim - 1] != ncols) {
+      std::stringstream message;
+      message << what << " must be an array of shape (N," << ncols
+              << ") or (" << ncols << ",)";
+      Python_value_error(message.str());
+   }
+   for (Int_t i=0; i < ndim; i++) {
+      if (strides[i] % (Py_intptr_t)sizeof(Double_t) != 0)
+         Python_value_error(what + " has strides that are not a"
+                            " multiple of the size of a double");
+   }
+   data = (const Double_t*)array.get_data();
+   col = strides[ndim - 1] / (Py_intptr_t)sizeof(Double_t);
+   row = 0;
+   if (ndim == 2) {
+      row = strides[0] / (Py_intptr_t)sizeof(Double_t);
+      if (nevents < 0) {
+         nevents = shape[0];
+      }
+      else if (shape[0] != nevents) {
+         std::stringstream message;
+         message << what << " has " << shape[0] << " rows, but "
+                 << nevents << " events were given for the other arguments";
+         Python_value_error(message.str());
+      }
+   }
+   return array;
+}
+
+Long64_t Batch_legs(Int_t process, boost::python::tuple args,
+                    Batch_leg_t *legs, std::vector<np::ndarray> &held)
+{
+   // Fills legs from the python arguments of the process, keeping the
+   // converted arrays in held, and returns the number of events, or -1
+   // if all of the legs are single vectors.
+
+   const Batch_process_t &proc = Batch_processes[process];
+   Long64_t nevents = -1;
+   for (Int_t leg=0; leg < proc.nlegs; leg++) {
+      std::stringstream what;
+      what << proc.name << " leg " << leg;
+      boost::python::object mom = args[leg];
+      boost::python::object pol;
+      legs[leg].mass = proc.mass[leg];
+      if (PyTuple_Check(mom.ptr())) {
+         boost::python::tuple tup(mom);
+         Int_t size = boost::python::len(tup);
+         if (size < 2 || size > 3)
+            Python_value_error(what.str() + " must be an array of momenta"
+                               " or a tuple (mom, pol[, mass])");
+         mom = tup[0];
+         pol = tup[1];
+         if (size == 3)
+            legs[leg].mass = boost::python::extract<Double_t>(tup[2]);
+      }
+      held.push_back(Batch_ndarray(mom, 4, nevents, legs[leg].mom,
+                                   legs[leg].momRow, legs[leg].momCol,
+                                   what.str() + " momentum"));
+      if (!pol.is_none()) {
+         held.push_back(Batch_ndarray(pol, 3, nevents, legs[leg].pol,
+                                      legs[leg].polRow, legs[leg].polCol,
+                                      what.str() + " polarization"));
+      }
+   }
+   return nevents;
+}
+
+void Batch_params(Int_t process, boost::python::object params,
+                  Long64_t nevents, Batch_params_t &par,
+                  std::vector<np::ndarray> &held)
+{
+   // Fills par with a view of the per-event parameters of process, for
+   // those processes that take any.
+
+   const Batch_process_t &proc = Batch_processes[process];
+   if (proc.nparams > 0) {
+      std::string what = std::string(proc.name) + " parameters";
+      if (params.is_none())
+         Python_value_error(what + " are required");
+      held.push_back(Batch_ndarray(params, proc.nparams, nevents, par.par,
+                                   par.parRow, par.parCol, what));
+   }
+}
+
+np::ndarray TCrossSection_batch(Int_t process, boost::python::tuple args,
+                                boost::python::object params,
+                                Int_t nthreads)
+{
+   std::vector<np::ndarray> held;
+   Batch_leg_t legs[Batch_max_legs];
+   Long64_t nevents = Batch_legs(process, args, legs, held);
+   Batch_params_t par;
+   Batch_params(process, params, nevents, par, held);
+   if (nevents < 0)
+      nevents = 1;
+   np::ndarray result = np::empty(boost::python::make_tuple(nevents),
+                                  np::dtype::get_builtin<Double_t>());
+   Double_t *data = (Double_t*)result.get_data();
+   {
+      Python_nogil_t nogil;
+      Batch_cross_sections(process, nevents, legs, par, data, nthreads);
+   }
+   return result;
+}
+
+np::ndarray TCrossSection_ComptonArray(boost::python::object gIn,
+                                       boost::python::object eIn,
+                                       boost::python::object gOut,
+                                       boost::python::object eOut,
+                                       Int_t nthreads) {
+   return TCrossSection_batch(kBatchCompton,
+          boost::python::make_tuple(gIn, eIn, gOut, eOut),
+          boost::python::object(), nthreads);
+}
+
+np::ndarray TCrossSection_BremsstrahlungArray(boost::python::object eIn,
+                                              boost::python::object eOut,
+                                              boost::python::object gOut,
+                                              Int_t nthreads) {
+   return TCrossSection_batch(kBatchBremsstrahlung,
+          boost::python::make_tuple(eIn, eOut, gOut),
+          boost::python::object(), nthreads);
+}
+
+np::ndarray TCrossSection_PairProductionArray(boost::python::object gIn,
+                                              boost::python::object eOut,
+                                              boost::python::object pOut,
+                                              Int_t nthreads) {
+   return TCrossSection_batch(kBatchPairProduction,
+          boost::python::make_tuple(gIn, eOut, pOut),
+          boost::python::object(), nthreads);
+}
+
+np::ndarray TCrossSection_TripletProductionArray(boost::python::object gIn,
+                                                 boost::python::object eIn,
+                                                 boost::python::object pOut,
+                                                 boost::python::object eOut2,
+                                                 boost::python::object eOut3,
+                                                 Int_t nthreads) {
+   return TCrossSection_batch(kBatchTripletProduction,
+          boost::python::make_tuple(gIn, eIn, pOut, eOut2, eOut3),
+          boost::python::object(), nthreads);
+}
+
+np::ndarray TCrossSection_BetheHeitlerNucleonArray(boost::python::object gIn,
+                                                   boost::python::object nIn,
+                                                   boost::python::object pOut,
+                                                   boost::python::object eOut,
+                                                   boost::python::object nOut,
+                                                   boost::python::object formFactors,
+                                                   Int_t nthreads) {
+   return TCrossSection_batch(kBatchBetheHeitlerNucleon,
+          boost::python::make_tuple(gIn, nIn, pOut, eOut, nOut),
+          formFactors, nthreads);
+}
+
+np::ndarray TCrossSection_eeBremsstrahlungArray(boost::python::object eIn0,
+                                                boost::python::object eIn1,
+                                                boost::python::object eOut2,
+                                                boost::python::object eOut3,
+                                                boost::python::object gOut,
+                                                Int_t nthreads) {
+   return TCrossSection_batch(kBatchEEBremsstrahlung,
+          boost::python::make_tuple(eIn0, eIn1, eOut2, eOut3, gOut),
+          boost::python::object(), nthreads);
+}
+
+np::ndarray TCrossSection_ePairProductionArray(boost::python::object eIn,
+                                               boost::python::object eOut,
+                                               boost::python::object lpOut,
+                                               boost::python::object lnOut,
+                                               Int_t nthreads) {
+   return TCrossSection_batch(kBatchEPairProduction,
+          boost::python::make_tuple(eIn, eOut, lpOut, lnOut),
+          boost::python::object(), nthreads);
+}
+
+np::ndarray TCrossSection_eTripletProductionArray(boost::python::object eIn,
+                                                  boost::python::object eOut,
+                                                  boost::python::object lpOut,
+                                                  boost::python::object lnOut,
+                                                  boost::python::object teIn,
+                                                  boost::python::object teOut,
+                                                  Int_t nthreads) {
+   return TCrossSection_batch(kBatchETripletProduction,
+          boost::python::make_tuple(eIn, eOut, lpOut, lnOut, teIn, teOut),
+          boost::python::object(), nthreads);
+}
+
+// Array versions of the TCrossSection amplitude methods, which take the
+// legs as above, without polarizations, and return a tuple (amp, kin)
+// of the helicity amplitudes of each event as a complex array of shape
+// (N,2^nlegs), in the order of TAmplitudeTensor, and the kinematical
+// factors that convert |M|^2 into the cross section, of shape (N,).
+
+boost::python::tuple TCrossSection_amplitude_batch(Int_t process,
+                                                   boost::python::tuple args,
+                                                   boost::python::object params,
+                                                   Int_t nthreads)
+{
+   std::vector<np::ndarray> held;
+   Batch_leg_t legs[Batch_max_legs];
+   Long64_t nevents = Batch_legs(process, args, legs, held);
+   Batch_params_t par;
+   Batch_params(process, params, nevents, par, held);
+   if (nevents < 0)
+      nevents = 1;
+   Int_t size = 1 << Batch_processes[process].nlegs;
+   np::ndarray amp = np::empty(boost::python::make_tuple(nevents, size),
+                               np::dtype::get_builtin<std::complex<Double_t> >());
+   np::ndarray kin = np::empty(boost::python::make_tuple(nevents),
+                               np::dtype::get_builtin<Double_t>());
+   {
+      Python_nogil_t nogil;
+      Batch_amplitudes(process, nevents, legs, par, (Double_t*)amp.get_data(),
+                       (Double_t*)kin.get_data(), nthreads);
+   }
+   return boost::python::make_tuple(amp, kin);
+}
+
+boost::python::tuple TCrossSection_BetheHeitlerNucleonAmplitudeArray(boost::python::object gIn,
+                                                                     boost::python::object nIn,
+                                                                     boost::python::object pOut,
+                                                                     boost::python::object eOut,
+                                                                     boost::python::object nOut,
+                                                                     boost::python::object formFactors,
+                                                                     Int_t nthreads) {
+   return TCrossSection_amplitude_batch(kBatchBetheHeitlerNucleon,
+          boost::python::make_tuple(gIn, nIn, pOut, eOut, nOut),
+          formFactors, nthreads);
+}
+
+boost::python::tuple TCrossSection_ePairProductionAmplitudeArray(boost::python::object eIn,
+                                                                 boost::python::object eOut,
+                                                                 boost::python::object lpOut,
+                                                                 boost::python::object lnOut,
+                                                                 Int_t nthreads) {
+   return TCrossSection_amplitude_batch(kBatchEPairProduction,
+          boost::python::make_tuple(eIn, eOut, lpOut, lnOut),
+          boost::python::object(), nthreads);
+}
+
+boost::python::tuple TCrossSection_eTripletProductionAmplitudeArray(boost::python::object eIn,
+                                                                    boost::python::object eOut,
+                                                                    boost::python::object lpOut,
+                                                                    boost::python::object lnOut,
+                                                                    boost::python::object teIn,
+                                                                    boost::python::object teOut,
+                                                                    Int_t nthreads) {
+   return TCrossSection_amplitude_batch(kBatchETripletProduction,
+          boost::python::make_tuple(eIn, eOut, lpOut, lnOut, teIn, teOut),
+          boost::python::object(), nthreads);
+}
+
+// Array versions of the kinematic methods of TFourVectorReal, which take
+// the four-vectors as an array of shape (N,4), and the argument of the
+// operation, if any, as an array of shape (N,k) or (k,), see Batch.h,
+// and return a new array of shape (N,4), (N,3) for GetPolarArray, or
+// (N,) for InvariantArray and ScalarProdArray.  The python global
+// interpreter lock is released while they are computed.
+
+np::ndarray TFourVectorReal_batch(Int_t op, boost::python::object vec,
+                                  boost::python::object arg, Int_t nthreads)
+{
+   const Batch_lorentz_t &info = Batch_lorentz_ops[op];
+   std::string name = std::string(info.name) + "Array";
+   Long64_t nevents = -1;
+   Batch_array_t v, a;
+   np::ndarray vheld = Batch_ndarray(vec, 4, nevents, v.data, v.row, v.col,
+                                     name + " vectors");
+   np::ndarray aheld = vheld;
+   if (info.nargs > 0) {
+      aheld = Batch_ndarray(arg, info.nargs, nevents, a.data, a.row, a.col,
+                            name + " argument");
+   }
+   if (nevents < 0)
+      nevents = 1;
+   np::ndarray result = (info.nout > 1)?
+                        np::empty(boost::python::make_tuple(nevents, info.nout),
+                                  np::dtype::get_builtin<Double_t>()) :
+                        np::empty(boost::python::make_tuple(nevents),
+                                  np::dtype::get_builtin<Double_t>());
+   Double_t *data = (Double_t*)result.get_data();
+   {
+      Python_nogil_t nogil;
+      Batch_lorentz(op, nevents, v, a, data, nthreads);
+   }
+   return result;
+}
+
+np::ndarray TFourVectorReal_BoostArray(boost::python::object vec,
+                                       boost::python::object beta,
+                                       Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchBoost, vec, beta, nthreads);
+}
+
+np::ndarray TFourVectorReal_BoostToRestArray(boost::python::object vec,
+                                             boost::python::object p,
+                                             Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchBoostToRest, vec, p, nthreads);
+}
+
+np::ndarray TFourVectorReal_RotateArray(boost::python::object vec,
+                                        boost::python::object axis,
+                                        Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchRotate, vec, axis, nthreads);
+}
+
+np::ndarray TFourVectorReal_RotateEulerArray(boost::python::object vec,
+                                             boost::python::object euler,
+                                             Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchRotateEuler, vec, euler, nthreads);
+}
+
+np::ndarray TFourVectorReal_InvariantArray(boost::python::object vec,
+                                           Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchInvariant, vec,
+                                boost::python::object(), nthreads);
+}
+
+np::ndarray TFourVectorReal_ScalarProdArray(boost::python::object vec,
+                                            boost::python::object other,
+                                            Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchScalarProd, vec, other, nthreads);
+}
+
+np::ndarray TFourVectorReal_GetPolarArray(boost::python::object vec,
+                                          Int_t nthreads)
+{
+   return TFourVectorReal_batch(kBatchPolar, vec,
+                                boost::python::object(), nthreads);
+}
+
+Complex_t TAmplitudeTensor_getitem(const TAmplitudeTensor &obj, Int_t index) {
+   if (index < 0 || index >= obj.Size()) {
+      PyErr_SetString(PyExc_IndexError, "TAmplitudeTensor index out of range");
+      boost::python::throw_error_already_set();
+   }
+   return obj[index];
+}
+
+Int_t TAmplitudeTensor_len(const TAmplitudeTensor &obj) {
+   return obj.Size();
+}
+
+void TAmplitudeTensor_Print(TAmplitudeTensor &obj) {
+   obj.Print();
+}
+
+// Buffer protocol for the value classes and for Batch_vectors_t, so that
+// numpy.asarray(obj) returns a writable view of the storage of obj,
+// without copying, that keeps obj alive.  The components of the vectors
+// and spinors, and the elements of the matrices in row order, appear as
+// long doubles (numpy.longdouble or numpy.clongdouble), which requires
+// LDouble_t to be the native long double, and the batches as doubles
+// of shape (N,ncomp) with the strides of their storage.
+
+struct Python_layout_t {
+   void *data;
+   const char *format;       // struct format of one element, or 0
+   Py_ssize_t itemsize;
+   Int_t ndim;
+   Py_ssize_t shape[2];
+   Py_ssize_t strides[2];    // in bytes
+};
+
+template <class T>
+const char *Python_format();
+
+template <>
+const char *Python_format<Double_t>() {
+   return "d";
+}
+
+#if defined DIRACXX_DOUBLE_DOUBLE || defined DIRACXX_FLOAT128
+template <>
+const char *Python_format<LDouble_t>() {
+   return 0;
+}
+
+template <>
+const char *Python_format<Complex_t>() {
+   return 0;
+}
+#elif defined DIRACXX_DOUBLE
+template <>
+const char *Python_format<Complex_t>() {
+   return "Zd";
+}
+#else
+template <>
+const char *Python_format<LDouble_t>() {
+   return "g";
+}
+
+template <>
+const char *Python_format<Complex_t>() {
+   return "Zg";
+}
+#endif
+
+template <class T>
+Python_layout_t *Python_layout(T *data, Py_ssize_t n0, Py_ssize_t s0,
+                               Py_ssize_t n1=0, Py_ssize_t s1=0) {
+   // Describes n0 elements at strides s0, or if n1 > 0 an n0 x n1 array
+   // at strides s0,s1, with strides in elements.
+
+   Python_layout_t *layout = new Python_layout_t;
+   layout->data = (void*)data;
+   layout->format = Python_format<T>();
+   layout->itemsize = sizeof(T);
+   layout->ndim = (n1 > 0)? 2 : 1;
+   layout->shape[0] = n0;
+   layout->shape[1] = n1;
+   layout->strides[0] = s0 * (Py_ssize_t)sizeof(T);
+   layout->strides[1] = s1 * (Py_ssize_t)sizeof(T);
+   return layout;
+}
+
+int Python_fill_buffer(PyObject *self, Py_buffer *view, int flags,
+                       Python_layout_t *layout) {
+   // Fills view from layout, which is kept until the view is released.
+
+   view->obj = 0;
+   if (layout->format == 0) {
+      delete layout;
+      PyErr_SetString(PyExc_BufferError, "buffer views of Dirac++ objects"
+                      " need LDouble_t to be the native long double");
+      return -1;
+   }
+   Py_ssize_t nelem = 1;
+   Bool_t contiguous = true;
+   Py_ssize_t stride = layout->itemsize;
+   for (Int_t i=layout->ndim - 1; i >= 0; i--) {
+      contiguous &= (layout->shape[i] < 2 || layout->strides[i] == stride);
+      stride *= layout->shape[i];
+      nelem *= layout->shape[i];
+   }
+   if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && !contiguous) {
+      delete layout;
+      PyErr_SetString(PyExc_BufferError, "this buffer is not contiguous,"
+                      " a strided view must be requested");
+      return -1;
+   }
+   view->buf = layout->data;
+   view->obj = self;
+   Py_INCREF(self);
+   view->len = nelem * layout->itemsize;
+   view->readonly = 0;
+   view->itemsize = layout->itemsize;
+   view->format = (flags & PyBUF_FORMAT)? (char*)layout->format : 0;
+   view->ndim = layout->ndim;
+   view->shape = (flags & PyBUF_ND)? layout->shape : 0;
+   view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)?
+                   layout->strides : 0;
+   view->suboffsets = 0;
+   view->internal = layout;
+   return 0;
+}
+
+template <Python_layout_t *(*layout)(PyObject *self)>
+int Python_getbuffer(PyObject *self, Py_buffer *view, int flags) {
+   return Python_fill_buffer(self, view, flags, layout(self));
+}
+
+void Python_releasebuffer(PyObject *self, Py_buffer *view) {
+   delete (Python_layout_t*)view->internal;
+}
+
+void Python_set_buffer(const boost::python::object &cls,
+                       PyBufferProcs *procs, Bool_t replace) {
+   // Points the buffer slots of cls at procs, unless it already has a
+   // buffer of its own and replace is false, and does the same for all
+   // of the subclasses of cls that exist so far.
+
+   PyTypeObject *type = (PyTypeObject*)cls.ptr();
+   if (replace || type->tp_as_buffer == 0 ||
+       type->tp_as_buffer->bf_getbuffer == 0)
+   {
+      type->tp_as_buffer = procs;
+      PyType_Modified(type);
+   }
+   boost::python::list subclasses(cls.attr("__subclasses__")());
+   for (Int_t i=0; i < boost::python::len(subclasses); i++) {
+      Python_set_buffer(subclasses[i], procs, false);
+   }
+}
+
+template <Python_layout_t *(*layout)(PyObject *self)>
+void Python_add_buffer(const boost::python::object &cls) {
+   // Gives the python class cls the buffer protocol, with the layout
+   // of each object returned by layout.  Boost.Python has readied the
+   // class by the time it is bound, and slots are only inherited when a
+   // type is readied, so they are also set here in the classes already
+   // derived from cls that have no buffer of their own.  Python classes
+   // derived from cls later inherit them in the usual way.
+
+   static PyBufferProcs procs = {&Python_getbuffer<layout>,
+                                 &Python_releasebuffer};
+   Python_set_buffer(cls, &procs, true);
+}
+
+Python_layout_t *TThreeVectorReal_layout(PyObject *self) {
+   TThreeVectorReal &obj = boost::python::extract<TThreeVectorReal&>(self);
+   return Python_layout(&obj[1], 3, 1);
+}
+
+Python_layout_t *TThreeVectorComplex_layout(PyObject *self) {
+   TThreeVectorComplex &obj = boost::python::extract<TThreeVectorComplex&>(self);
+   return Python_layout(&obj[1], 3, 1);
+}
+
+Python_layout_t *TFourVectorReal_layout(PyObject *self) {
+   TFourVectorReal &obj = boost::python::extract<TFourVectorReal&>(self);
+   return Python_layout(&obj[0], 4, 1);
+}
+
+Python_layout_t *TFourVectorComplex_layout(PyObject *self) {
+   TFourVectorComplex &obj = boost::python::extract<TFourVectorComplex&>(self);
+   return Python_layout(&obj[0], 4, 1);
+}
+
+Python_layout_t *TPauliSpinor_layout(PyObject *self) {
+   TPauliSpinor &obj = boost::python::extract<TPauliSpinor&>(self);
+   return Python_layout(&obj[0], 2, 1);
+}
+
+Python_layout_t *TDiracSpinor_layout(PyObject *self) {
+   TDiracSpinor &obj = boost::python::extract<TDiracSpinor&>(self);
+   return Python_layout(&obj[0], 4, 1);
+}
+
+Python_layout_t *TPauliMatrix_layout(PyObject *self) {
+   TPauliMatrix &obj = boost::python::extract<TPauliMatrix&>(self);
+   return Python_layout(obj[0], 2, 2, 2, 1);
+}
+
+Python_layout_t *TDiracMatrix_layout(PyObject *self) {
+   TDiracMatrix &obj = boost::python::extract<TDiracMatrix&>(self);
+   return Python_layout(obj[0], 4, 4, 4, 1);
+}
+
+Python_layout_t *TAmplitudeTensor_layout(PyObject *self) {
+   TAmplitudeTensor &obj = boost::python::extract<TAmplitudeTensor&>(self);
+   return Python_layout(&obj[0], obj.Size(), 1);
+}
+
+Python_layout_t *Batch_vectors_layout(PyObject *self) {
+   Batch_vectors_t &obj = boost::python::extract<Batch_vectors_t&>(self);
+   return Python_layout(obj.Data(), obj.Size(), obj.RowStride(),
+                        obj.Components(), obj.ColStride());
+}
+
+Batch_vectors_t *Batch_vectors_wrap(boost::python::object obj) {
+   // Returns a batch that views the array obj of shape (N,ncomp), which
+   // must already be a writable array of doubles, without copying.  The
+   // binding keeps obj alive for as long as the batch.
+
+   boost::python::extract<np::ndarray> isarray(obj);
+   if (!isarray.check())
+      Python_value_error("BatchVectors.Wrap needs a NumPy array");
+   np::ndarray array = isarray();
+   Int_t flags = np::ndarray::ALIGNED | np::ndarray::WRITEABLE;
+   if (array.get_dtype() != np::dtype::get_builtin<Double_t>() ||
+       array.get_nd() != 2 || (array.get_flags() & flags) != flags)
+   {
+      Python_value_error("BatchVectors.Wrap needs an aligned, writable"
+                         " float64 array of shape (N,ncomp)");
+   }
+   const Py_intptr_t *shape = array.get_shape();
+   const Py_intptr_t *strides = array.get_strides();
+   if (strides[0] % (Py_intptr_t)sizeof(Double_t) != 0 ||
+       strides[1] % (Py_intptr_t)sizeof(Double_t) != 0)
+   {
+      Python_value_error("BatchVectors.Wrap needs strides that are a"
+                         " multiple of the size of a double");
+   }
+   return new Batch_vectors_t((Double_t*)array.get_data(), shape[0],
+                              shape[1], strides[0] / sizeof(Double_t),
+                              strides[1] / sizeof(Double_t));
+}
+
+Long64_t Batch_vectors_len(const Batch_vectors_t &obj) {
+   return obj.Size();
+}
+
+// Pickle support for the value classes, leptons and photons, whose
+// state is the binary image of Pickle.h in the native format, so that
+// they are restored exactly, and the static methods PackArray, which
+// packs a sequence of objects of one class into a single image, in
+// double if double=True, and UnpackArray, which returns the list of
+// objects in an image held by any object with the buffer protocol,
+// such as bytes or a shared memory view.  The python global interpreter
+// lock is released while the components are copied.
+
+void Python_pickle_check(Int_t status, const std::string &what) {
+   if (status == 1)
+      Python_value_error(what + " data is not an image of this class");
+   else if (status == 2)
+      Python_value_error(what + " data was written by a build with a"
+                         " different LDouble_t");
+   else if (status == 3)
+      Python_value_error(what + " data is truncated");
+}
+
+template <class T>
+boost::python::object Pickle_pack(const std::vector<const T*> &objs,
+                                  Bool_t dbl)
+{
+   size_t size = Pickle_size<T>(objs.size(), dbl);
+   boost::python::handle<> bytes(PyBytes_FromStringAndSize(0, size));
+   char *buf = PyBytes_AS_STRING(bytes.get());
+   {
+      Python_nogil_t nogil;
+      buf = Pickle_header<T>(buf, objs.size(), dbl);
+      for (UInt_t i=0; i < objs.size(); i++)
+         buf = Pickle_write(buf, *objs[i], dbl);
+   }
+   return boost::python::object(bytes);
+}
+
+template <class T>
+void Pickle_unpack(boost::python::object data, std::vector<T> &objs,
+                   const std::string &what)
+{
+   Py_buffer view;
+   if (PyObject_GetBuffer(data.ptr(), &view, PyBUF_SIMPLE) != 0)
+      boost::python::throw_error_already_set();
+   const char *buf = (const char*)view.buf;
+   UInt_t n;
+   Bool_t dbl;
+   Int_t status = Pickle_check<T>(buf, view.len, n, dbl);
+   if (status == 0) {
+      objs.resize(n);
+      Python_nogil_t nogil;
+      buf += Pickle_header_size;
+      for (UInt_t i=0; i < n; i++)
+         buf = Pickle_read(buf, objs[i], dbl);
+   }
+   PyBuffer_Release(&view);
+   Python_pickle_check(status, what);
+}
+
+template <class T>
+struct Pickle_suite_t : boost::python::pickle_suite {
+   static boost::python::object getstate(const T &obj) {
+      return Pickle_pack(std::vector<const T*>(1, &obj), false);
+   }
+
+   static void setstate(T &obj, boost::python::object state) {
+      std::vector<T> objs;
+      Pickle_unpack(state, objs, "__setstate__");
+      if (objs.size() != 1)
+         Python_value_error("__setstate__ data must hold one object");
+      obj = objs[0];
+   }
+};
+
+template <class T>
+boost::python::object Pickle_pack_array(boost::python::object seq,
+                                        Bool_t dbl)
+{
+   Long64_t n = boost::python::len(seq);
+   if (n > (Long64_t)kMaxUInt)
+      Python_value_error("PackArray can pack at most 2^32-1 objects");
+   // The items are held until they are packed, since seq[i] may be a
+   // new object for a sequence that is not a list.
+   std::vector<boost::python::object> items(n);
+   std::vector<const T*> objs(n);
+   for (Long64_t i=0; i < n; i++) {
+      items[i] = seq[i];
+      const T &obj = boost::python::extract<const T&>(items[i]);
+      objs[i] = &obj;
+   }
+   return Pickle_pack(objs, dbl);
+}
+
+template <class T>
+boost::python::list Pickle_unpack_array(boost::python::object data)
+{
+   std::vector<T> objs;
+   Pickle_unpack(data, objs, "UnpackArray");
+   boost::python::list result;
+   for (UInt_t i=0; i < objs.size(); i++)
+      result.append(objs[i]);
+   return result;
+}
+
+// Python iterators over the events of the pair and triplet generators,
+// which yield the events in chunks as NumPy structured arrays with the
+// fields of PairsStream_event_t and TripletsStream_event_t, generated
+// ahead of the consumer by the background threads of a Stream_t.  The
+// global interpreter lock is released while waiting for a chunk, and
+// each array owns its chunk, so it may be kept after the iteration.
+
+struct Python_field_t {
+   const char *name;
+   const char *format;
+   size_t offset;
+};
+
+#define DIRACXX_FIELD(type, name, format) { #name, format, offsetof(type, name) }
+
+const Python_field_t PairsStream_fields[] = {
+   DIRACXX_FIELD(PairsStream_event_t, E0, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, Epos, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, phi12, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, Mpair, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, qR2, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, phiR, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, diffXS, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, weight, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, weightedXS, "f8"),
+   DIRACXX_FIELD(PairsStream_event_t, eOut, "(4,)f8"),
+   DIRACXX_FIELD(PairsStream_event_t, pOut, "(4,)f8"),
+   DIRACXX_FIELD(PairsStream_event_t, qRecoil, "(3,)f8"),
+   DIRACXX_FIELD(PairsStream_event_t, hel, "i4"),
+   DIRACXX_FIELD(PairsStream_event_t, trials, "i4"),
+   { 0, 0, 0 }
+};
+
+const Python_field_t TripletsStream_fields[] = {
+   DIRACXX_FIELD(TripletsStream_event_t, E0, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, Epos, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, phi12, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, Mpair, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, qR2, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, phiR, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, thetaR, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, diffXS, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, weight, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, weightedXS, "f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, urand, "(5,)f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, e1, "(4,)f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, e2, "(4,)f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, e3, "(4,)f8"),
+   DIRACXX_FIELD(TripletsStream_event_t, hel, "i4"),
+   DIRACXX_FIELD(TripletsStream_event_t, trials, "i4"),
+   { 0, 0, 0 }
+};
+
+np::dtype Python_dtype(const Python_field_t *fields, size_t itemsize) {
+   // Returns the NumPy structured dtype with the given fields, ending
+   // with a null name, and the given itemsize.
+
+   boost::python::list names, formats, offsets;
+   for (Int_t i=0; fields[i].name; i++) {
+      names.append(fields[i].name);
+      formats.append(fields[i].format);
+      offsets.append(fields[i].offset);
+   }
+   boost::python::dict spec;
+   spec["names"] = names;
+   spec["formats"] = formats;
+   spec["offsets"] = offsets;
+   spec["itemsize"] = itemsize;
+   return np::dtype(spec);
+}
+
+// The arrays returned by the streams view their chunks without copying,
+// and the capsule that owns each chunk holds a reference to the python
+// stream object, so that the chunk can be given back to the stream for
+// reuse when the array is collected, see Stream_t::Recycle.
+
+template <class Event>
+void Stream_free(PyObject *capsule) {
+   Event *events = (Event*)PyCapsule_GetPointer(capsule, "Stream chunk");
+   PyObject *self = (PyObject*)PyCapsule_GetContext(capsule);
+   Stream_t<Event> &stream = boost::python::extract<Stream_t<Event>&>(self);
+   stream.Recycle(events);
+   Py_DECREF(self);
+}
+
+template <class Event>
+np::ndarray Stream_next(boost::python::object self,
+                        const Python_field_t *fields) {
+   Stream_t<Event> &stream = boost::python::extract<Stream_t<Event>&>(self);
+   Event *events;
+   {
+      Python_nogil_t nogil;
+      events = stream.Next();
+   }
+   if (events == 0) {
+      PyErr_SetNone(PyExc_StopIteration);
+      boost::python::throw_error_already_set();
+   }
+   PyObject *capsule = PyCapsule_New(events, "Stream chunk", 0);
+   if (capsule == 0) {
+      stream.Recycle(events);
+      boost::python::throw_error_already_set();
+   }
+   PyCapsule_SetContext(capsule, self.ptr());
+   Py_INCREF(self.ptr());
+   PyCapsule_SetDestructor(capsule, &Stream_free<Event>);
+   boost::python::object owner((boost::python::handle<>(capsule)));
+   return np::from_data(events, Python_dtype(fields, sizeof(Event)),
+                        boost::python::make_tuple(stream.Chunk()),
+                        boost::python::make_tuple(sizeof(Event)),
+                        owner);
+}
+
+template <class Event>
+void Stream_stop(Stream_t<Event> &stream) {
+   Python_nogil_t nogil;
+   stream.Stop();
+}
+
+boost::python::object Stream_iter(boost::python::object self) {
+   return self;
+}
+
+Stream_t<PairsStream_event_t> *PairsStream_new(Double_t kin, Int_t chunk,
+                                               Long64_t nchunks,
+                                               Int_t nthreads,
+                                               Int_t prefetch, UInt_t seed,
+                                               Bool_t sampleHelicities)
+{
+   return new Stream_t<PairsStream_event_t>(
+      [kin, sampleHelicities](PairsStream_event_t *events, Int_t n,
+                              TRandom &random_gen) {
+         return PairsStream_fill(events, n, kin, random_gen,
+                                 sampleHelicities);
+      }, chunk, nchunks, nthreads, prefetch, seed);
+}
+
+np::ndarray PairsStream_next(boost::python::object self) {
+   return Stream_next<PairsStream_event_t>(self, PairsStream_fields);
+}
+
+Stream_t<TripletsStream_event_t> *TripletsStream_new(Double_t kin,
+                                                     Int_t chunk,
+                                                     Long64_t nchunks,
+                                                     Int_t nthreads,
+                                                     Int_t prefetch,
+                                                     UInt_t seed,
+                                                     Bool_t sampleHelicities)
+{
+   return new Stream_t<TripletsStream_event_t>(
+      [kin, sampleHelicities](TripletsStream_event_t *events, Int_t n,
+                              TRandom &random_gen) {
+         return TripletsStream_fill(events, n, kin, random_gen,
+                                    sampleHelicities);
+      }, chunk, nchunks, nthreads, prefetch, seed);
+}
+
+np::ndarray TripletsStream_next(boost::python::object self) {
+   return Stream_next<TripletsStream_event_t>(self, TripletsStream_fields);
+}
+
 ///////////////////////////////////////////////////////////
 // Create a python module containing all of the user classes
 // that are needed to interact with Dirac++ objects from python.
@@ -435,6 +1434,8 @@ void TCrossSection_Print(TCrossSection &obj) {
 
 BOOST_PYTHON_MODULE(libDirac)
 {
+   np::initialize();
+
    boost::python::enum_<EPauliIndex>("EPauliIndex")
       .value("kPauliOne", kPauliOne)
       .value("kPauliSigma1", kPauliSigma1)
@@ -515,6 +1516,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TThreeVectorReal::operator-)
       .def("Print", &TThreeVectorReal::Print)
       .def("Print", &TThreeVectorReal_Print)
+      .def_pickle(Pickle_suite_t<TThreeVectorReal>())
+      .def("PackArray", &Pickle_pack_array<TThreeVectorReal>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TThreeVectorReal>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TThreeVectorComplex, TThreeVectorComplex*>
@@ -575,6 +1582,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TThreeVectorComplex::operator-)
       .def("Print", &TThreeVectorComplex::Print)
       .def("Print", &TThreeVectorComplex_Print)
+      .def_pickle(Pickle_suite_t<TThreeVectorComplex>())
+      .def("PackArray", &Pickle_pack_array<TThreeVectorComplex>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TThreeVectorComplex>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TFourVectorReal, TFourVectorReal*,
@@ -612,15 +1625,15 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Transform", &TFourVectorReal::Transform,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorReal_Boost,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorReal_Boost, &TFourVectorReal::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorReal_Boost1,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorReal_Boost1, &TFourVectorReal::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorReal_Boost2,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorReal_Boost2, &TFourVectorReal::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorReal_Boost3,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorReal_Boost3, &TFourVectorReal::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorReal_Boost4,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorReal_Boost4, &TFourVectorReal::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("BoostToRest", &TFourVectorReal::BoostToRest,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
@@ -628,8 +1641,40 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("ScalarProd", &TFourVectorReal::ScalarProd)
       .def("__neg__", &TFourVectorReal::operator-)
+      .def("BoostArray", &TFourVectorReal_BoostArray,
+           (boost::python::arg("vec"), boost::python::arg("beta"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("BoostArray")
+      .def("BoostToRestArray", &TFourVectorReal_BoostToRestArray,
+           (boost::python::arg("vec"), boost::python::arg("p"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("BoostToRestArray")
+      .def("RotateArray", &TFourVectorReal_RotateArray,
+           (boost::python::arg("vec"), boost::python::arg("axis"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("RotateArray")
+      .def("RotateEulerArray", &TFourVectorReal_RotateEulerArray,
+           (boost::python::arg("vec"), boost::python::arg("euler"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("RotateEulerArray")
+      .def("InvariantArray", &TFourVectorReal_InvariantArray,
+           (boost::python::arg("vec"), boost::python::arg("nthreads")=1))
+      .staticmethod("InvariantArray")
+      .def("ScalarProdArray", &TFourVectorReal_ScalarProdArray,
+           (boost::python::arg("vec"), boost::python::arg("other"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("ScalarProdArray")
+      .def("GetPolarArray", &TFourVectorReal_GetPolarArray,
+           (boost::python::arg("vec"), boost::python::arg("nthreads")=1))
+      .staticmethod("GetPolarArray")
       .def("Print", &TFourVectorReal::Print)
       .def("Print", &TFourVectorReal_Print)
+      .def_pickle(Pickle_suite_t<TFourVectorReal>())
+      .def("PackArray", &Pickle_pack_array<TFourVectorReal>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TFourVectorReal>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TFourVectorComplex, TFourVectorComplex*,
@@ -678,15 +1723,15 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Transform", &TFourVectorComplex::Transform,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorComplex_Boost1,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorComplex_Boost1, &TFourVectorComplex::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorComplex_Boost2,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorComplex_Boost2, &TFourVectorComplex::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorComplex_Boost3,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorComplex_Boost3, &TFourVectorComplex::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost",TFourVectorComplex_Boost4,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorComplex_Boost4, &TFourVectorComplex::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TFourVectorComplex_Boost,
+      .def("Boost", DIRACXX_NOGIL(TFourVectorComplex_Boost, &TFourVectorComplex::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("BoostFromRest", &TFourVectorComplex::BoostFromRest,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
@@ -697,6 +1742,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TFourVectorComplex::operator-)
       .def("Print", &TFourVectorComplex::Print)
       .def("Print", &TFourVectorComplex_Print)
+      .def_pickle(Pickle_suite_t<TFourVectorComplex>())
+      .def("PackArray", &Pickle_pack_array<TFourVectorComplex>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TFourVectorComplex>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TLorentzTransform, TLorentzTransform*>
@@ -722,8 +1773,8 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Invert", &TLorentzBoost::Invert,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def(boost::python::self_ns::self *= TLorentzTransform())
-      .def(boost::python::self_ns::self * TLorentzTransform())
+      .def("__imul__", &TLorentzTransform_imul, boost::python::return_self<>())
+      .def("__mul__", &TLorentzTransform_mul)
       .def(boost::python::self_ns::self * TFourVectorComplex())
       .def(boost::python::self_ns::self * TFourVectorReal())
       .def("__eq__", &TLorentzTransform::operator==)
@@ -880,6 +1931,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TPauliMatrix::operator-)
       .def("Print", &TPauliMatrix::Print)
       .def("Print", &TPauliMatrix_Print)
+      .def_pickle(Pickle_suite_t<TPauliMatrix>())
+      .def("PackArray", &Pickle_pack_array<TPauliMatrix>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TPauliMatrix>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TDiracMatrix, TDiracMatrix*>
@@ -902,7 +1959,7 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("IsHermetian", &TDiracMatrix::IsHermetian)
       .def("IsIdempotent", &TDiracMatrix::IsIdempotent)
       .def("Trace", &TDiracMatrix::Trace)
-      .def("Determ", &TDiracMatrix::Determ)
+      .def("Determ", DIRACXX_NOGIL(&TDiracMatrix::Determ, &TDiracMatrix::Determ))
       .def("Component", TDiracMatrix_Component1)
       .def("Component", TDiracMatrix_Component2)
       .def("GetDiagonal", &TDiracMatrix::GetDiagonal)
@@ -912,10 +1969,10 @@ BOOST_PYTHON_MODULE(libDirac)
       .def(boost::python::self_ns::self -= TDiracMatrix())
       .def(boost::python::self_ns::self -= Complex_t())
       .def(boost::python::self_ns::self -= LDouble_t())
-      .def(boost::python::self_ns::self *= TDiracMatrix())
+      .def("__imul__", &TDiracMatrix_imul, boost::python::return_self<>())
       .def(boost::python::self_ns::self *= Complex_t())
       .def(boost::python::self_ns::self *= LDouble_t())
-      .def(boost::python::self_ns::self /= TDiracMatrix())
+      .def("__itruediv__", &TDiracMatrix_idiv, boost::python::return_self<>())
       .def(boost::python::self_ns::self /= Complex_t())
       .def(boost::python::self_ns::self /= LDouble_t())
       .def(boost::python::self_ns::self + TDiracMatrix())
@@ -928,12 +1985,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def(boost::python::self_ns::self - LDouble_t())
       .def(Complex_t() - boost::python::self_ns::self)
       .def(LDouble_t() - boost::python::self_ns::self)
-      .def(boost::python::self_ns::self * TDiracMatrix())
+      .def("__mul__", &TDiracMatrix_mul)
       .def(boost::python::self_ns::self * Complex_t())
       .def(boost::python::self_ns::self * LDouble_t())
       .def(Complex_t() * boost::python::self_ns::self)
       .def(LDouble_t() * boost::python::self_ns::self)
-      .def(boost::python::self_ns::self / TDiracMatrix())
+      .def("__truediv__", &TDiracMatrix_div)
       .def(boost::python::self_ns::self / Complex_t())
       .def(boost::python::self_ns::self / LDouble_t())
       .def(Complex_t() / boost::python::self_ns::self)
@@ -944,7 +2001,7 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Conj", &TDiracMatrix::Conj,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Invert", &TDiracMatrix::Invert,
+      .def("Invert", DIRACXX_NOGIL(&TDiracMatrix::Invert, &TDiracMatrix::Invert),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Adjoint", &TDiracMatrix::Adjoint,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
@@ -982,13 +2039,13 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("SetRotation", TDiracMatrix_SetRotation3,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("SetBoost", TDiracMatrix_SetBoost,
+      .def("SetBoost", DIRACXX_NOGIL(TDiracMatrix_SetBoost, &TDiracMatrix::SetBoost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("SetBoost", TDiracMatrix_SetBoost1,
+      .def("SetBoost", DIRACXX_NOGIL(TDiracMatrix_SetBoost1, &TDiracMatrix::SetBoost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("SetBoost", TDiracMatrix_SetBoost2,
+      .def("SetBoost", DIRACXX_NOGIL(TDiracMatrix_SetBoost2, &TDiracMatrix::SetBoost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("SetBoost", TDiracMatrix_SetBoost3,
+      .def("SetBoost", DIRACXX_NOGIL(TDiracMatrix_SetBoost3, &TDiracMatrix::SetBoost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("SetTransform", &TDiracMatrix::SetTransform,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
@@ -1003,6 +2060,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TDiracMatrix::operator-)
       .def("Print", &TDiracMatrix::Print)
       .def("Print", &TDiracMatrix_Print)
+      .def_pickle(Pickle_suite_t<TDiracMatrix>())
+      .def("PackArray", &Pickle_pack_array<TDiracMatrix>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TDiracMatrix>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TPauliSpinor, TPauliSpinor*>
@@ -1063,6 +2126,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TPauliSpinor::operator-)
       .def("Print", &TPauliSpinor::Print)
       .def("Print", &TPauliSpinor_Print)
+      .def_pickle(Pickle_suite_t<TPauliSpinor>())
+      .def("PackArray", &Pickle_pack_array<TPauliSpinor>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TPauliSpinor>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TDiracSpinor, TDiracSpinor*>
@@ -1126,15 +2195,15 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Rotate", TDiracSpinor_Rotate3,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TDiracSpinor_Boost,
+      .def("Boost", DIRACXX_NOGIL(TDiracSpinor_Boost, &TDiracSpinor::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TDiracSpinor_Boost1,
+      .def("Boost", DIRACXX_NOGIL(TDiracSpinor_Boost1, &TDiracSpinor::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TDiracSpinor_Boost2,
+      .def("Boost", DIRACXX_NOGIL(TDiracSpinor_Boost2, &TDiracSpinor::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TDiracSpinor_Boost3,
+      .def("Boost", DIRACXX_NOGIL(TDiracSpinor_Boost3, &TDiracSpinor::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
-      .def("Boost", TDiracSpinor_Boost4,
+      .def("Boost", DIRACXX_NOGIL(TDiracSpinor_Boost4, &TDiracSpinor::Boost),
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("BoostToRest", &TDiracSpinor::BoostToRest,
            boost::python::return_value_policy<boost::python::reference_existing_object>())
@@ -1145,6 +2214,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("__neg__", &TDiracSpinor::operator-)
       .def("Print", &TDiracSpinor::Print)
       .def("Print", &TDiracSpinor_Print)
+      .def_pickle(Pickle_suite_t<TDiracSpinor>())
+      .def("PackArray", &Pickle_pack_array<TDiracSpinor>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TDiracSpinor>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TLepton, TLepton*>
@@ -1171,6 +2246,12 @@ BOOST_PYTHON_MODULE(libDirac)
            boost::python::return_value_policy<boost::python::reference_existing_object>())
       .def("Print", &TLepton::Print)
       .def("Print", &TLepton_Print)
+      .def_pickle(Pickle_suite_t<TLepton>())
+      .def("PackArray", &Pickle_pack_array<TLepton>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TLepton>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TPhoton, TPhoton*>
@@ -1200,6 +2281,12 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("GetPolarizationPlane", &TPhoton::GetPolarizationPlane)
       .def("Print", &TPhoton::Print)
       .def("Print", &TPhoton_Print)
+      .def_pickle(Pickle_suite_t<TPhoton>())
+      .def("PackArray", &Pickle_pack_array<TPhoton>,
+           (boost::python::arg("objs"), boost::python::arg("double")=false))
+      .staticmethod("PackArray")
+      .def("UnpackArray", &Pickle_unpack_array<TPhoton>)
+      .staticmethod("UnpackArray")
    ;
 
    boost::python::class_<TGhoston, TGhoston*,
@@ -1214,20 +2301,181 @@ BOOST_PYTHON_MODULE(libDirac)
       .def("Print", &TGhoston_Print)
    ;
 
+   boost::python::class_<TAmplitudeTensor, TAmplitudeTensor*>
+         ("TAmplitudeTensor",
+          "helicity amplitudes of a QED process")
+      .def(boost::python::init<const Int_t, const Int_t>())
+      .def(boost::python::init<const TAmplitudeTensor &>())
+      .def("__getitem__", &TAmplitudeTensor_getitem)
+      .def("__len__", &TAmplitudeTensor_len)
+      .def("Legs", &TAmplitudeTensor::Legs)
+      .def("Size", &TAmplitudeTensor::Size)
+      .def("IsFinal", &TAmplitudeTensor::IsFinal)
+      .def("FinalMask", &TAmplitudeTensor::FinalMask)
+      .def("Helicity", &TAmplitudeTensor::Helicity)
+      .def("KinFactor", &TAmplitudeTensor::KinFactor)
+      .def("SetLegs", &TAmplitudeTensor::SetLegs,
+           boost::python::return_value_policy<boost::python::reference_existing_object>())
+      .def("SetKinFactor", &TAmplitudeTensor::SetKinFactor,
+           boost::python::return_value_policy<boost::python::reference_existing_object>())
+      .def("Zero", &TAmplitudeTensor::Zero,
+           boost::python::return_value_policy<boost::python::reference_existing_object>())
+      .def("Print", &TAmplitudeTensor::Print)
+      .def("Print", &TAmplitudeTensor_Print)
+   ;
+
    boost::python::class_<TCrossSection, TCrossSection*>
          ("TCrossSection",
           "methods for computing various QED polarized cross sections")
-      .def("Compton", &TCrossSection::Compton)
+      .def("Compton", DIRACXX_NOGIL(&TCrossSection::Compton,
+                                &TCrossSection::Compton))
       .staticmethod("Compton")
-      .def("Bremsstrahlung", &TCrossSection::Bremsstrahlung)
+      .def("Bremsstrahlung", DIRACXX_NOGIL(&TCrossSection::Bremsstrahlung,
+                                &TCrossSection::Bremsstrahlung))
       .staticmethod("Bremsstrahlung")
-      .def("PairProduction", &TCrossSection::PairProduction)
+      .def("PairProduction", DIRACXX_NOGIL(&TCrossSection::PairProduction,
+                                &TCrossSection::PairProduction))
       .staticmethod("PairProduction")
-      .def("TripletProduction", &TCrossSection::TripletProduction)
+      .def("TripletProduction", DIRACXX_NOGIL(&TCrossSection::TripletProduction,
+                                &TCrossSection::TripletProduction))
       .staticmethod("TripletProduction")
-      .def("eeBremsstrahlung", &TCrossSection::eeBremsstrahlung)
+      .def("eeBremsstrahlung", DIRACXX_NOGIL(&TCrossSection::eeBremsstrahlung,
+                                &TCrossSection::eeBremsstrahlung))
       .staticmethod("eeBremsstrahlung")
+      .def("BetheHeitlerNucleon", DIRACXX_NOGIL(&TCrossSection::BetheHeitlerNucleon,
+                                &TCrossSection::BetheHeitlerNucleon))
+      .staticmethod("BetheHeitlerNucleon")
+      .def("ePairProduction", DIRACXX_NOGIL(&TCrossSection::ePairProduction,
+                                &TCrossSection::ePairProduction))
+      .staticmethod("ePairProduction")
+      .def("eTripletProduction", DIRACXX_NOGIL(&TCrossSection::eTripletProduction,
+                                &TCrossSection::eTripletProduction))
+      .staticmethod("eTripletProduction")
+      .def("BetheHeitlerNucleonAmplitude", DIRACXX_NOGIL(&TCrossSection::BetheHeitlerNucleonAmplitude,
+                                &TCrossSection::BetheHeitlerNucleonAmplitude))
+      .staticmethod("BetheHeitlerNucleonAmplitude")
+      .def("ePairProductionAmplitude", DIRACXX_NOGIL(&TCrossSection::ePairProductionAmplitude,
+                                &TCrossSection::ePairProductionAmplitude))
+      .staticmethod("ePairProductionAmplitude")
+      .def("eTripletProductionAmplitude", DIRACXX_NOGIL(&TCrossSection::eTripletProductionAmplitude,
+                                &TCrossSection::eTripletProductionAmplitude))
+      .staticmethod("eTripletProductionAmplitude")
+      .def("ComptonArray", &TCrossSection_ComptonArray,
+           (boost::python::arg("gIn"), boost::python::arg("eIn"),
+            boost::python::arg("gOut"), boost::python::arg("eOut"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("ComptonArray")
+      .def("BremsstrahlungArray", &TCrossSection_BremsstrahlungArray,
+           (boost::python::arg("eIn"), boost::python::arg("eOut"),
+            boost::python::arg("gOut"), boost::python::arg("nthreads")=1))
+      .staticmethod("BremsstrahlungArray")
+      .def("PairProductionArray", &TCrossSection_PairProductionArray,
+           (boost::python::arg("gIn"), boost::python::arg("eOut"),
+            boost::python::arg("pOut"), boost::python::arg("nthreads")=1))
+      .staticmethod("PairProductionArray")
+      .def("TripletProductionArray", &TCrossSection_TripletProductionArray,
+           (boost::python::arg("gIn"), boost::python::arg("eIn"),
+            boost::python::arg("pOut"), boost::python::arg("eOut2"),
+            boost::python::arg("eOut3"), boost::python::arg("nthreads")=1))
+      .staticmethod("TripletProductionArray")
+      .def("BetheHeitlerNucleonArray", &TCrossSection_BetheHeitlerNucleonArray,
+           (boost::python::arg("gIn"), boost::python::arg("nIn"),
+            boost::python::arg("pOut"), boost::python::arg("eOut"),
+            boost::python::arg("nOut"), boost::python::arg("formFactors"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("BetheHeitlerNucleonArray")
+      .def("eeBremsstrahlungArray", &TCrossSection_eeBremsstrahlungArray,
+           (boost::python::arg("eIn0"), boost::python::arg("eIn1"),
+            boost::python::arg("eOut2"), boost::python::arg("eOut3"),
+            boost::python::arg("gOut"), boost::python::arg("nthreads")=1))
+      .staticmethod("eeBremsstrahlungArray")
+      .def("ePairProductionArray", &TCrossSection_ePairProductionArray,
+           (boost::python::arg("eIn"), boost::python::arg("eOut"),
+            boost::python::arg("lpOut"), boost::python::arg("lnOut"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("ePairProductionArray")
+      .def("eTripletProductionArray", &TCrossSection_eTripletProductionArray,
+           (boost::python::arg("eIn"), boost::python::arg("eOut"),
+            boost::python::arg("lpOut"), boost::python::arg("lnOut"),
+            boost::python::arg("teIn"), boost::python::arg("teOut"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("eTripletProductionArray")
+      .def("BetheHeitlerNucleonAmplitudeArray", &TCrossSection_BetheHeitlerNucleonAmplitudeArray,
+           (boost::python::arg("gIn"), boost::python::arg("nIn"),
+            boost::python::arg("pOut"), boost::python::arg("eOut"),
+            boost::python::arg("nOut"), boost::python::arg("formFactors"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("BetheHeitlerNucleonAmplitudeArray")
+      .def("ePairProductionAmplitudeArray", &TCrossSection_ePairProductionAmplitudeArray,
+           (boost::python::arg("eIn"), boost::python::arg("eOut"),
+            boost::python::arg("lpOut"), boost::python::arg("lnOut"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("ePairProductionAmplitudeArray")
+      .def("eTripletProductionAmplitudeArray", &TCrossSection_eTripletProductionAmplitudeArray,
+           (boost::python::arg("eIn"), boost::python::arg("eOut"),
+            boost::python::arg("lpOut"), boost::python::arg("lnOut"),
+            boost::python::arg("teIn"), boost::python::arg("teOut"),
+            boost::python::arg("nthreads")=1))
+      .staticmethod("eTripletProductionAmplitudeArray")
       .def("Print", &TCrossSection::Print)
       .def("Print", &TCrossSection_Print)
    ;
+
+   boost::python::class_<Batch_vectors_t, boost::noncopyable>
+         ("BatchVectors",
+          "batch of N real vectors, stored by component or viewing an array",
+          boost::python::init<Long64_t, boost::python::optional<Int_t> >())
+      .def("Wrap", &Batch_vectors_wrap,
+           boost::python::return_value_policy<boost::python::manage_new_object,
+                boost::python::with_custodian_and_ward_postcall<0, 1> >())
+      .staticmethod("Wrap")
+      .def("Size", &Batch_vectors_t::Size)
+      .def("Components", &Batch_vectors_t::Components)
+      .def("IsView", &Batch_vectors_t::IsView)
+      .def("__len__", &Batch_vectors_len)
+   ;
+
+   boost::python::class_<Stream_t<PairsStream_event_t>, boost::noncopyable>
+         ("PairsStream",
+          "iterator over chunks of generated e+e- pair events",
+          boost::python::no_init)
+      .def("__init__", boost::python::make_constructor(&PairsStream_new,
+           boost::python::default_call_policies(),
+           (boost::python::arg("kin")=9., boost::python::arg("chunk")=65536,
+            boost::python::arg("nchunks")=-1, boost::python::arg("nthreads")=1,
+            boost::python::arg("prefetch")=4, boost::python::arg("seed")=0,
+            boost::python::arg("sampleHelicities")=false)))
+      .def("__iter__", &Stream_iter)
+      .def("__next__", &PairsStream_next)
+      .def("Chunk", &Stream_t<PairsStream_event_t>::Chunk)
+      .def("Stop", &Stream_stop<PairsStream_event_t>)
+   ;
+
+   boost::python::class_<Stream_t<TripletsStream_event_t>, boost::noncopyable>
+         ("TripletsStream",
+          "iterator over chunks of generated e-e+e- triplet events",
+          boost::python::no_init)
+      .def("__init__", boost::python::make_constructor(&TripletsStream_new,
+           boost::python::default_call_policies(),
+           (boost::python::arg("kin")=9., boost::python::arg("chunk")=65536,
+            boost::python::arg("nchunks")=-1, boost::python::arg("nthreads")=1,
+            boost::python::arg("prefetch")=4, boost::python::arg("seed")=0,
+            boost::python::arg("sampleHelicities")=false)))
+      .def("__iter__", &Stream_iter)
+      .def("__next__", &TripletsStream_next)
+      .def("Chunk", &Stream_t<TripletsStream_event_t>::Chunk)
+      .def("Stop", &Stream_stop<TripletsStream_event_t>)
+   ;
+
+   boost::python::scope module;
+   Python_add_buffer<TThreeVectorReal_layout>(module.attr("TThreeVectorReal"));
+   Python_add_buffer<TThreeVectorComplex_layout>(module.attr("TThreeVectorComplex"));
+   Python_add_buffer<TFourVectorReal_layout>(module.attr("TFourVectorReal"));
+   Python_add_buffer<TFourVectorComplex_layout>(module.attr("TFourVectorComplex"));
+   Python_add_buffer<TPauliSpinor_layout>(module.attr("TPauliSpinor"));
+   Python_add_buffer<TDiracSpinor_layout>(module.attr("TDiracSpinor"));
+   Python_add_buffer<TPauliMatrix_layout>(module.attr("TPauliMatrix"));
+   Python_add_buffer<TDiracMatrix_layout>(module.attr("TDiracMatrix"));
+   Python_add_buffer<TAmplitudeTensor_layout>(module.attr("TAmplitudeTensor"));
+   Python_add_buffer<Batch_vectors_layout>(module.attr("BatchVectors"));
 }
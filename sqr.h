@@ -4,7 +4,9 @@ inline unsigned int sqr(unsigned int x) { return x*x; }
 inline Int_t sqr(Int_t x) { return x*x; }
 inline Float_t sqr(Float_t x) { return x*x; }
 inline Double_t sqr(Double_t x) { return x*x; }
+#if !defined DIRACXX_DOUBLE
 inline LDouble_t sqr(LDouble_t x) { return x*x; }
+#endif
 inline Complex_t sqr(Complex_t x) { return x*x; }
 #endif
 